@@ -0,0 +1,254 @@
+/**
+ * @file bench_axes.cpp
+ * @brief 单轴数据布局基准
+ *
+ * 不依赖EtherCAT硬件，在内存中模拟多轴过程数据域，对比两种单轴数据布局的周期开销：
+ * - 分散布局：偏移量数组、适配器指针、状态机、最近命令分别保存在独立分配的容器中
+ * - 控制块布局：每个轴一个缓存行对齐的AxisBlock
+ *
+ * 每个周期之间遍历一块较大的缓冲区以模拟其他任务对缓存的驱逐，只统计轴循环本身。
+ * 支持perf_event时同时输出每周期L1D读缺失与LLC读缺失。
+ *
+ * 用法: ./bench_axes [轴数量=48] [周期数=20000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <memory>
+#include <vector>
+#include "axis_data.hpp"
+
+namespace {
+
+const size_t kRxBytes = 14;     // 0x6040/0x607A/0x60FF/0x6071/0x6060/0x60C2
+const size_t kTxBytes = 18;     // 0x6041/0x6064/0x606C/0x6077/0x6061/0x603F/0x2026
+const size_t kEntries = 13;     // Rx 6项 + Tx 7项
+const size_t kEvictBytes = 4 * 1024 * 1024;
+
+/**
+ * @brief 模拟适配器，仅用于占位指针
+ */
+struct FakeAdapter {
+    int id;
+};
+
+uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint16_t load_u16(const uint8_t* p) { uint16_t v; memcpy(&v, p, sizeof(v)); return v; }
+int32_t load_s32(const uint8_t* p) { int32_t v; memcpy(&v, p, sizeof(v)); return v; }
+void store_u16(uint8_t* p, uint16_t v) { memcpy(p, &v, sizeof(v)); }
+void store_s32(uint8_t* p, int32_t v) { memcpy(p, &v, sizeof(v)); }
+
+/**
+ * @brief 硬件计数器，不可用时所有读数为0
+ */
+class PerfCounter {
+public:
+    PerfCounter(uint32_t type, uint64_t config) : fd_(-1) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    ~PerfCounter() { if (fd_ >= 0) close(fd_); }
+
+    bool valid() const { return fd_ >= 0; }
+    void start() { if (fd_ >= 0) { ioctl(fd_, PERF_EVENT_IOC_RESET, 0); ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0); } }
+    void stop() { if (fd_ >= 0) ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0); }
+    uint64_t read_value() const {
+        uint64_t v = 0;
+        if (fd_ >= 0 && ::read(fd_, &v, sizeof(v)) != (ssize_t)sizeof(v)) v = 0;
+        return v;
+    }
+
+private:
+    int fd_;
+};
+
+const uint64_t kL1dReadMiss = PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+/**
+ * @brief 分散布局：模拟原先MotorApi的并行容器
+ */
+struct ScatteredAxes {
+    std::vector<std::vector<unsigned int>> offsets;
+    std::vector<std::shared_ptr<FakeAdapter>> adapters;
+    std::vector<Cia402StateMachine> machines;
+    std::vector<uint16_t> last_control;
+    std::vector<int32_t> last_target;
+    std::vector<std::vector<char>> padding;   // 穿插的其他分配，模拟长期运行后的堆
+
+    void build(size_t axes) {
+        for (size_t m = 0; m < axes; ++m) {
+            std::vector<unsigned int> off(kEntries);
+            const unsigned int base = (unsigned int)(m * (kRxBytes + kTxBytes));
+            const unsigned int rx[] = {0, 2, 6, 10, 12, 13};
+            const unsigned int tx[] = {0, 2, 6, 10, 12, 13, 15};
+            for (size_t i = 0; i < 6; ++i) off[i] = base + rx[i];
+            for (size_t i = 0; i < 7; ++i) off[6 + i] = base + (unsigned int)kRxBytes + tx[i];
+            offsets.push_back(off);
+            padding.push_back(std::vector<char>(200 + (m * 37) % 300));
+            adapters.push_back(std::make_shared<FakeAdapter>());
+            padding.push_back(std::vector<char>(150 + (m * 53) % 200));
+        }
+        machines.assign(axes, Cia402StateMachine());
+        last_control.assign(axes, 0);
+        last_target.assign(axes, 0);
+    }
+
+    int cycle(uint8_t* pd) {
+        int live = 0;
+        for (size_t m = 0; m < offsets.size(); ++m) {
+            std::shared_ptr<FakeAdapter> adapter = adapters[m];
+            const std::vector<unsigned int>& off = offsets[m];
+            uint16_t status = load_u16(pd + off[6]);
+            int32_t actual = load_s32(pd + off[7]);
+            bool run = false;
+            uint16_t control = machines[m].step(status, run);
+            int32_t target = run ? actual + 10 : actual;
+            store_u16(pd + off[0], control);
+            store_s32(pd + off[1], target);
+            last_control[m] = control;
+            last_target[m] = target;
+            live += adapter->id;
+        }
+        return live;
+    }
+};
+
+/**
+ * @brief 控制块布局
+ */
+struct BlockAxes {
+    AlignedArray<AxisBlock> axes;
+
+    void build(size_t n) {
+        axes.reset(n);
+        for (size_t m = 0; m < n; ++m) {
+            const unsigned int base = (unsigned int)(m * (kRxBytes + kTxBytes));
+            PdoSlots& s = axes[m].slots;
+            s.control_word = base + 0;
+            s.target_position = base + 2;
+            s.status_word = base + (unsigned int)kRxBytes + 0;
+            s.actual_position = base + (unsigned int)kRxBytes + 2;
+        }
+    }
+
+    int cycle(uint8_t* pd) {
+        int live = 0;
+        AxisBlock* a = axes.data();
+        for (size_t m = 0; m < axes.size(); ++m) {
+            AxisBlock& axis = a[m];
+            uint16_t status = load_u16(pd + axis.slots.status_word);
+            int32_t actual = load_s32(pd + axis.slots.actual_position);
+            bool run = false;
+            uint16_t control = axis.machine.step(status, run);
+            int32_t target = run ? actual + 10 : actual;
+            store_u16(pd + axis.slots.control_word, control);
+            store_s32(pd + axis.slots.target_position, target);
+            axis.last_control = control;
+            axis.last_target = target;
+            live += axis.adapter != nullptr;
+        }
+        return live;
+    }
+};
+
+struct Result {
+    double ns_per_cycle;
+    double l1d_miss_per_cycle;
+    double llc_miss_per_cycle;
+    bool counters;
+};
+
+template <typename Axes>
+Result run(Axes& axes, size_t n, size_t cycles, std::vector<uint8_t>& domain, std::vector<uint8_t>& evict) {
+    PerfCounter l1d(PERF_TYPE_HW_CACHE, kL1dReadMiss);
+    PerfCounter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    uint64_t total_ns = 0, l1d_total = 0, llc_total = 0;
+    volatile int sink = 0;
+
+    for (size_t c = 0; c < cycles; ++c) {
+        // 模拟驱动器状态推进：0x0250 -> 0x0231 -> 0x0233 -> 0x0237
+        static const uint16_t seq[] = {0x0250, 0x0231, 0x0233, 0x0237};
+        const uint16_t sw = seq[(c / 8) < 3 ? (c / 8) : 3];
+        for (size_t m = 0; m < n; ++m) {
+            uint8_t* tx = &domain[m * (kRxBytes + kTxBytes) + kRxBytes];
+            store_u16(tx, sw);
+            store_s32(tx + 2, (int32_t)(c * 10 + m));
+        }
+
+        // 其他任务驱逐缓存
+        for (size_t i = 0; i < evict.size(); i += 64) evict[i]++;
+
+        l1d.start();
+        llc.start();
+        uint64_t t0 = now_ns();
+        sink += axes.cycle(domain.data());
+        uint64_t t1 = now_ns();
+        l1d.stop();
+        llc.stop();
+        total_ns += t1 - t0;
+        l1d_total += l1d.read_value();
+        llc_total += llc.read_value();
+    }
+    (void)sink;
+
+    Result r;
+    r.ns_per_cycle = (double)total_ns / cycles;
+    r.l1d_miss_per_cycle = (double)l1d_total / cycles;
+    r.llc_miss_per_cycle = (double)llc_total / cycles;
+    r.counters = l1d.valid() || llc.valid();
+    return r;
+}
+
+void print(const char* name, const Result& r) {
+    if (r.counters) {
+        printf("%-10s %10.1f ns/cycle  %8.1f L1D-miss/cycle  %8.1f LLC-miss/cycle\n",
+               name, r.ns_per_cycle, r.l1d_miss_per_cycle, r.llc_miss_per_cycle);
+    } else {
+        printf("%-10s %10.1f ns/cycle  (perf counters unavailable)\n", name, r.ns_per_cycle);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t axes = argc > 1 ? (size_t)strtoul(argv[1], NULL, 0) : 48;
+    size_t cycles = argc > 2 ? (size_t)strtoul(argv[2], NULL, 0) : 20000;
+    if (axes == 0 || cycles == 0) {
+        fprintf(stderr, "usage: %s [axes] [cycles]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> domain(axes * (kRxBytes + kTxBytes), 0);
+    std::vector<uint8_t> evict(kEvictBytes, 0);
+
+    ScatteredAxes scattered;
+    scattered.build(axes);
+    BlockAxes blocks;
+    blocks.build(axes);
+
+    printf("axes=%zu cycles=%zu sizeof(AxisBlock)=%zu\n", axes, cycles, sizeof(AxisBlock));
+    print("scattered", run(scattered, axes, cycles, domain, evict));
+    print("blocks", run(blocks, axes, cycles, domain, evict));
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file bench_workers.cpp
+ * @brief 多核并行轴计算基准
+ *
+ * 不依赖EtherCAT硬件，每轴执行一段模拟计算（五次多项式插补、四级双二阶滤波、
+ * 两连杆运动学），对比串行与AxisWorkerPool并行的周期耗时：
+ * - 不同轴数量、不同工作线程数下的每周期耗时与加速比
+ * - 空任务下的屏障开销（发布任务到全部线程完成的往返时间）
+ *
+ * 工作线程在屏障上自旋，线程数应不超过空闲CPU数；默认取CPU数-1，
+ * 工作线程依次绑定到CPU 1、2、...，主线程绑定到CPU 0。
+ *
+ * 用法: ./bench_workers [最大工作线程数=CPU数-1] [周期数=5000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <vector>
+#include "axis_data.hpp"
+#include "axis_worker_pool.hpp"
+
+namespace {
+
+/**
+ * @brief 单轴计算状态，每轴独占缓存行
+ */
+struct alignas(kCacheLineSize) AxisState {
+    double coeff[6];        // 五次多项式系数
+    double biquad[4][4];    // 四级滤波器状态 x1 x2 y1 y2
+    double t;               // 插补时间
+    double out;             // 输出
+};
+
+uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 单轴模拟计算
+ */
+void compute_axis(AxisState& a) {
+    static const double b0 = 0.0675, b1 = 0.1349, b2 = 0.0675, a1 = -1.1430, a2 = 0.4128;
+
+    a.t += 0.001;
+    if (a.t > 1.0) a.t = 0.0;
+    double x = a.coeff[5];
+    for (int k = 4; k >= 0; --k) x = x * a.t + a.coeff[k];
+
+    for (int s = 0; s < 4; ++s) {
+        double* z = a.biquad[s];
+        double y = b0 * x + b1 * z[0] + b2 * z[1] - a1 * z[2] - a2 * z[3];
+        z[1] = z[0]; z[0] = x; z[3] = z[2]; z[2] = y;
+        x = y;
+    }
+
+    // 两连杆正逆运动学
+    double q1 = x * 0.5, q2 = x * 0.25;
+    double px = cos(q1) + 0.8 * cos(q1 + q2);
+    double py = sin(q1) + 0.8 * sin(q1 + q2);
+    double c2 = (px * px + py * py - 1.0 - 0.64) / 1.6;
+    if (c2 > 1.0) c2 = 1.0;
+    if (c2 < -1.0) c2 = -1.0;
+    a.out = atan2(py, px) - atan2(0.8 * sqrt(1.0 - c2 * c2), 1.0 + 0.8 * c2);
+}
+
+void pin_self(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/**
+ * @brief 测量每周期平均耗时
+ */
+double measure(AxisWorkerPool& pool, AlignedArray<AxisState>& axes, size_t n, size_t cycles) {
+    AxisWorkerPool::RangeFn fn = [&axes](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m) compute_axis(axes[m]);
+    };
+    for (size_t c = 0; c < cycles / 10; ++c) pool.run(n, fn);   // 预热
+
+    uint64_t t0 = now_ns();
+    for (size_t c = 0; c < cycles; ++c) pool.run(n, fn);
+    return (double)(now_ns() - t0) / cycles;
+}
+
+/**
+ * @brief 测量空任务的屏障往返开销
+ */
+double measure_barrier(AxisWorkerPool& pool, size_t cycles) {
+    AxisWorkerPool::RangeFn fn = [](size_t, size_t) {};
+    for (size_t c = 0; c < cycles / 10; ++c) pool.run(64, fn);
+
+    uint64_t t0 = now_ns();
+    for (size_t c = 0; c < cycles; ++c) pool.run(64, fn);
+    return (double)(now_ns() - t0) / cycles;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_workers = argc > 1 ? (size_t)strtoul(argv[1], NULL, 0) : (size_t)(cpus > 1 ? cpus - 1 : 0);
+    size_t cycles = argc > 2 ? (size_t)strtoul(argv[2], NULL, 0) : 5000;
+    if (cycles == 0) {
+        fprintf(stderr, "usage: %s [max_workers] [cycles]\n", argv[0]);
+        return 1;
+    }
+    if (cpus > 1) pin_self(0);
+
+    static const size_t kAxisCounts[] = {8, 16, 24, 48, 96};
+    const size_t max_axes = kAxisCounts[sizeof(kAxisCounts) / sizeof(kAxisCounts[0]) - 1];
+    AlignedArray<AxisState> axes;
+    axes.reset(max_axes);
+    for (size_t m = 0; m < max_axes; ++m) {
+        for (int k = 0; k < 6; ++k) axes[m].coeff[k] = 0.1 * (k + 1) + 0.01 * m;
+        for (int s = 0; s < 4; ++s) for (int k = 0; k < 4; ++k) axes[m].biquad[s][k] = 0.0;
+        axes[m].t = 0.0;
+        axes[m].out = 0.0;
+    }
+
+    printf("cpus=%ld max_workers=%zu cycles=%zu\n", cpus, max_workers, cycles);
+    if ((long)max_workers >= cpus) {
+        printf("warning: workers spin, more threads than idle CPUs will not speed up\n");
+    }
+
+    std::vector<double> serial(sizeof(kAxisCounts) / sizeof(kAxisCounts[0]));
+    for (size_t workers = 0; workers <= max_workers; ++workers) {
+        AxisWorkerPool pool;
+        WorkerPoolConfig config;
+        config.workers = workers;
+        for (size_t i = 0; i < workers; ++i) config.cpus.push_back(cpus > 1 ? (int)((i + 1) % cpus) : -1);
+        if (!pool.start(config)) return 1;
+
+        printf("\nworkers=%zu (threads=%zu)", workers, workers + 1);
+        if (workers) printf("  barrier %.0f ns", measure_barrier(pool, cycles * 10));
+        printf("\n");
+        for (size_t i = 0; i < sizeof(kAxisCounts) / sizeof(kAxisCounts[0]); ++i) {
+            size_t n = kAxisCounts[i];
+            double ns = measure(pool, axes, n, cycles);
+            if (workers == 0) serial[i] = ns;
+            printf("  axes=%-3zu %9.0f ns/cycle  speedup %.2fx\n", n, ns, serial[i] / ns);
+        }
+        pool.stop();
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+#ifndef AXIS_DATA_HPP
+#define AXIS_DATA_HPP
+
+/**
+ * @file axis_data.hpp
+ * @brief 轴级数据结构定义
+ *
+ * 定义MotorApi与电机适配器在周期路径中共享的轴级数据结构。
+ * 这些结构只在初始化阶段分配和填充，周期内只做定长读写。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+#include <vector>
+#include "cia402_state_machine.hpp"
+
+class MotorAdapter;
+
+/**
+ * @brief 缓存行大小（字节）
+ *
+ * 堆上按块分配的数组（AlignedArray）可以用alignas对齐到缓存行；作为其他类直接成员的
+ * 共享字段则改用kCacheLineSize字节的填充数组隔开，以免外层对象成为C++11下new无法保证的
+ * 超对齐类型。
+ */
+static const size_t kCacheLineSize = 64;
+
+/**
+ * @brief 未映射PDO槽位标记
+ *
+ * 适配器未映射某个对象时，对应槽位取该值，访问函数据此直接跳过。
+ */
+static const unsigned int kNoPdoSlot = ~0u;
+
+/**
+ * @brief 单轴PDO槽位表
+ *
+ * 在init_auto()/init_from_eni()完成PDO注册后，将常用CiA 402对象
+ * 一次性解析为域内字节偏移。周期内的访问只需一次边界检查和一次读写，
+ * 不再复制适配器指针、不再构造PDO配置数组、也不再线性查找。
+ */
+struct PdoSlots {
+    unsigned int control_word;      ///< 0x6040 控制字
+    unsigned int target_position;   ///< 0x607A 目标位置
+    unsigned int target_velocity;   ///< 0x60FF 目标速度
+    unsigned int target_torque;     ///< 0x6071 目标力矩
+    unsigned int op_mode;           ///< 0x6060 操作模式
+    unsigned int resv1;             ///< 0x60C2 保留参数1
+    unsigned int status_word;       ///< 0x6041 状态字
+    unsigned int actual_position;   ///< 0x6064 实际位置
+    unsigned int actual_velocity;   ///< 0x606C 实际速度
+    unsigned int actual_torque;     ///< 0x6077 实际力矩
+    unsigned int op_mode_display;   ///< 0x6061 操作模式显示
+    unsigned int error_code;        ///< 0x603F 错误代码
+};
+
+/**
+ * @brief 全轴输入快照（结构数组形式）
+ *
+ * receive_and_process()之后一次性解码所有轴的TxPDO字段，
+ * 每个字段在内存中连续存放，便于逐字段顺序扫描。
+ * 数组在初始化阶段按电机数量分配，周期内不再分配内存。
+ */
+struct AxisSnapshot {
+    std::vector<uint16_t> status_word;      ///< 0x6041 状态字
+    std::vector<int32_t> actual_position;   ///< 0x6064 实际位置
+    std::vector<int32_t> actual_velocity;   ///< 0x606C 实际速度
+    std::vector<int16_t> actual_torque;     ///< 0x6077 实际力矩
+    std::vector<int8_t> mode_display;       ///< 0x6061 操作模式显示
+    std::vector<uint16_t> error_code;       ///< 0x603F 错误代码
+
+    /**
+     * @brief 按轴数量分配并清零所有字段
+     * @param axes 轴数量
+     */
+    void resize(size_t axes) {
+        status_word.assign(axes, 0);
+        actual_position.assign(axes, 0);
+        actual_velocity.assign(axes, 0);
+        actual_torque.assign(axes, 0);
+        mode_display.assign(axes, 0);
+        error_code.assign(axes, 0);
+    }
+
+    /**
+     * @brief 获取快照包含的轴数量
+     * @return 轴数量
+     */
+    size_t size() const { return status_word.size(); }
+};
+
+/**
+ * @brief 单轴周期控制块
+ *
+ * 周期内访问一个轴所需的全部数据集中在一个按缓存行对齐的块中：
+ * PDO槽位、适配器指针、CiA 402状态机以及最近一次写出的命令。
+ * 从站配置、完整偏移量数组、适配器所有权等只在初始化和诊断时使用的
+ * 数据保存在别处，不与本块共享缓存行。
+ */
+struct alignas(kCacheLineSize) AxisBlock {
+    PdoSlots slots;                 ///< 常用对象的域内偏移
+    const MotorAdapter* adapter;    ///< 适配器（所有权在MotorApi::motor_adapters_）
+    Cia402StateMachine machine;     ///< CiA 402状态机
+    uint16_t last_control;          ///< 最近写入的控制字
+    int32_t last_target;            ///< 最近写入的目标位置
+    int32_t sent_target;            ///< 最近一次发送时的目标位置
+    int32_t target_delta;           ///< 最近两个周期发出的目标位置之差，用于超时外推
+    bool target_valid;              ///< 是否已写入过目标位置
+    bool sent_valid;                ///< sent_target是否有效
+
+    AxisBlock()
+        : adapter(nullptr), last_control(0), last_target(0), sent_target(0), target_delta(0),
+          target_valid(false), sent_valid(false) {}
+
+    /**
+     * @brief 记录写入的目标位置
+     * @param pos 目标位置
+     *
+     * 一个周期内可能多次写入（设定值流后回调覆盖、异步操作与回调、降级策略），只保留最后一次
+     */
+    void record_target(int32_t pos) {
+        last_target = pos;
+        target_valid = true;
+    }
+
+    /**
+     * @brief 发送时锁存本周期的目标位置，按周期而不是按写入次数计算差值
+     */
+    void latch_target() {
+        if (!target_valid) return;
+        target_delta = sent_valid ? last_target - sent_target : 0;
+        sent_target = last_target;
+        sent_valid = true;
+    }
+};
+
+/**
+ * @brief 按缓存行对齐的定长数组
+ * @tparam T 元素类型
+ *
+ * 以posix_memalign分配一整块连续内存，元素在初始化阶段构造，
+ * 周期内不再分配。不可复制。
+ */
+template <typename T>
+class AlignedArray {
+public:
+    AlignedArray() : data_(nullptr), size_(0) {}
+    ~AlignedArray() { reset(0); }
+
+    /**
+     * @brief 重新分配并默认构造元素
+     * @param n 元素数量，0表示释放
+     * @return true 成功，false 内存不足
+     */
+    bool reset(size_t n) {
+        for (size_t i = 0; i < size_; ++i) data_[i].~T();
+        free(data_);
+        data_ = nullptr;
+        size_ = 0;
+        if (n == 0) return true;
+
+        void* mem = nullptr;
+        const size_t align = alignof(T) > kCacheLineSize ? alignof(T) : kCacheLineSize;
+        if (posix_memalign(&mem, align, n * sizeof(T)) != 0) return false;
+        data_ = static_cast<T*>(mem);
+        for (size_t i = 0; i < n; ++i) new (&data_[i]) T();
+        size_ = n;
+        return true;
+    }
+
+    size_t size() const { return size_; }
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+private:
+    AlignedArray(const AlignedArray&);
+    AlignedArray& operator=(const AlignedArray&);
+
+    T* data_;       ///< 元素数组
+    size_t size_;   ///< 元素数量
+};
+
+#endif // AXIS_DATA_HPP
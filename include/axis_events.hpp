@@ -0,0 +1,156 @@
+#ifndef AXIS_EVENTS_HPP
+#define AXIS_EVENTS_HPP
+
+/**
+ * @file axis_events.hpp
+ * @brief 轴状态变化事件流
+ *
+ * 总线线程每周期比较各轴的状态字、操作模式显示和错误代码，只在变化时写入一条
+ * 带周期号和时间戳的事件。事件保存在单生产者广播环形队列中，任意数量的消费者
+ * 各自持有读取游标、按自己的节奏读取；生产者从不等待，消费者落后超过队列容量时
+ * 最旧的事件被覆盖并计入游标的丢失数。消费者的工作量与事件数成正比，与轴数和周期数无关。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief 发生变化的字段
+ */
+enum class AxisEventField : uint8_t {
+    StatusWord,     ///< 0x6041 状态字（按屏蔽字比较）
+    ModeDisplay,    ///< 0x6061 操作模式显示
+    ErrorCode       ///< 0x603F 错误代码
+};
+
+/**
+ * @brief 状态变化事件
+ */
+struct AxisEvent {
+    uint64_t cycle;             ///< 检测到变化的接收序号（与snapshot_seq()一致）
+    uint64_t timestamp_ns;      ///< 该次接收完成的时间（CLOCK_MONOTONIC纳秒）
+    uint16_t axis;              ///< 轴索引
+    AxisEventField field;       ///< 发生变化的字段
+    uint8_t reserved;           ///< 保留
+    uint16_t old_value;         ///< 变化前的值（操作模式显示按uint8_t保存）
+    uint16_t new_value;         ///< 变化后的值
+
+    /**
+     * @brief 获取变化的位
+     */
+    uint16_t changed() const { return old_value ^ new_value; }
+
+    /**
+     * @brief 判断(值 & mask) == value是否由不成立变为成立，如entered(0x6F, 0x27)表示进入操作使能
+     */
+    bool entered(uint16_t mask, uint16_t value) const {
+        return (old_value & mask) != value && (new_value & mask) == value;
+    }
+
+    /**
+     * @brief 判断(值 & mask) == value是否由成立变为不成立
+     */
+    bool left(uint16_t mask, uint16_t value) const {
+        return (old_value & mask) == value && (new_value & mask) != value;
+    }
+};
+
+/**
+ * @brief 消费者读取游标
+ */
+struct AxisEventCursor {
+    uint64_t next;  ///< 下一个要读取的事件序号
+    uint64_t lost;  ///< 因落后被覆盖而丢失的事件数
+
+    AxisEventCursor() : next(0), lost(0) {}
+};
+
+/**
+ * @brief 轴状态变化事件流
+ */
+class AxisEventStream {
+public:
+    AxisEventStream();
+
+    /**
+     * @brief 分配队列并清空（不得与detect()、read()并发）
+     * @param axes 轴数量
+     * @param capacity 队列容量，向上取整为2的幂
+     * @param status_mask 状态字比较屏蔽字，只有屏蔽字内的位变化才产生事件
+     * @return true 成功，false 参数无效
+     */
+    bool reset(size_t axes, size_t capacity, uint16_t status_mask);
+
+    /**
+     * @brief 是否已分配
+     */
+    bool enabled() const { return !slots_.empty(); }
+
+    /**
+     * @brief 比较本周期输入并写入事件（总线线程）
+     * @param cycle 接收序号
+     * @param timestamp_ns 接收完成时间
+     * @param status 各轴状态字
+     * @param mode 各轴操作模式显示
+     * @param error 各轴错误代码
+     *
+     * 第一次调用只记录基准值，不产生事件
+     */
+    void detect(uint64_t cycle, uint64_t timestamp_ns, const uint16_t* status, const int8_t* mode,
+                const uint16_t* error);
+
+    /**
+     * @brief 获取只读取此后新事件的游标
+     */
+    AxisEventCursor cursor() const;
+
+    /**
+     * @brief 读取事件（任意线程，可多个消费者）
+     * @param cursor 读取游标，读取后前移
+     * @param out 输出数组
+     * @param max 最多读取的事件数
+     * @return 读取的事件数，没有新事件时为0
+     */
+    size_t read(AxisEventCursor& cursor, AxisEvent* out, size_t max) const;
+
+    /**
+     * @brief 获取已产生的事件总数
+     */
+    uint64_t produced() const { return head_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 获取队列容量
+     */
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    AxisEventStream(const AxisEventStream&);
+    AxisEventStream& operator=(const AxisEventStream&);
+
+    /**
+     * @brief 事件槽
+     *
+     * 第i个事件写入时seq为2i+1，写完为2i+2；读取方据此判断槽内是否为所需事件且未被覆盖
+     */
+    struct Slot {
+        std::atomic<uint64_t> seq;  ///< 写入序号
+        AxisEvent event;            ///< 事件
+
+        Slot() : seq(0) {}
+    };
+
+    void push(const AxisEvent& event);
+
+    std::vector<Slot> slots_;               ///< 环形缓冲区
+    size_t mask_;                           ///< 容量-1
+    uint16_t status_mask_;                  ///< 状态字比较屏蔽字
+    bool primed_;                           ///< 是否已记录基准值
+    std::vector<uint16_t> last_status_;     ///< 上一周期的状态字（已屏蔽）
+    std::vector<int8_t> last_mode_;         ///< 上一周期的操作模式显示
+    std::vector<uint16_t> last_error_;      ///< 上一周期的错误代码
+    std::atomic<uint64_t> head_;            ///< 已产生的事件数（仅总线线程写）
+};
+
+#endif // AXIS_EVENTS_HPP
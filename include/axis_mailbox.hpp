@@ -0,0 +1,162 @@
+#ifndef AXIS_MAILBOX_HPP
+#define AXIS_MAILBOX_HPP
+
+/**
+ * @file axis_mailbox.hpp
+ * @brief 总线线程与应用线程之间的轴数据交换区
+ *
+ * 线程模式下只有总线线程访问域数据。总线线程每周期把各轴输入发布到双缓冲的反馈区，
+ * 应用线程随时读取最近一次完整发布的副本；应用线程的命令写入各轴的命令槽，
+ * 总线线程每周期取走一次。总线线程从不等待应用线程：命令槽正被写入时本周期跳过，
+ * 下一周期再取。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+#include "axis_data.hpp"
+
+/**
+ * @brief 单轴反馈（总线线程每周期发布）
+ */
+struct AxisFeedback {
+    uint16_t status_word;       ///< 0x6041 状态字
+    int32_t actual_position;    ///< 0x6064 实际位置
+    int32_t actual_velocity;    ///< 0x606C 实际速度
+    int16_t actual_torque;      ///< 0x6077 实际力矩
+    int8_t mode_display;        ///< 0x6061 操作模式显示
+    uint16_t error_code;        ///< 0x603F 错误代码
+    uint8_t drive_state;        ///< 总线线程状态机最近识别的状态（Cia402State）
+};
+
+/**
+ * @brief 单轴命令（应用线程写入，总线线程每周期取走）
+ *
+ * fields中置位的字段有效，写入后保持有效，总线线程在命令变化的周期把有效字段全部写出
+ */
+struct AxisCommand {
+    enum {
+        kControl = 1u << 0,     ///< control有效
+        kTarget = 1u << 1,      ///< target_position有效
+        kOpMode = 1u << 2       ///< op_mode、resv1有效
+    };
+    uint32_t fields;            ///< 有效字段
+    uint16_t control;           ///< 控制字
+    int32_t target_position;    ///< 目标位置
+    uint8_t op_mode;            ///< 操作模式
+    uint8_t resv1;              ///< 保留参数1
+
+    AxisCommand() : fields(0), control(0), target_position(0), op_mode(0), resv1(0) {}
+};
+
+/**
+ * @brief 轴数据交换区
+ */
+class AxisMailbox {
+public:
+    AxisMailbox();
+
+    /**
+     * @brief 按轴数量分配并清零（不得与读写并发）
+     * @param axes 轴数量
+     * @return true 成功，false 内存不足
+     */
+    bool reset(size_t axes);
+
+    /**
+     * @brief 获取轴数量
+     */
+    size_t size() const { return slots_.size(); }
+
+    /**
+     * @brief 获取反馈写入区（总线线程）
+     * @return 下一次发布使用的缓冲区，填写完毕后调用publish()
+     */
+    AxisFeedback* feedback_back();
+
+    /**
+     * @brief 发布反馈写入区（总线线程）
+     */
+    void publish();
+
+    /**
+     * @brief 读取最近一次发布的反馈（任意线程）
+     * @param fn 复制函数，形如void(const AxisFeedback* all, size_t axes)
+     *
+     * 复制期间有新的发布时重新复制，返回时fn最后一次看到的是一份完整的发布。
+     * 总线线程每周期发布一次，复制耗时远小于周期时几乎不会重试
+     */
+    template <typename Fn>
+    void read(Fn fn) const;
+
+    /**
+     * @brief 读取单轴反馈（任意线程）
+     */
+    AxisFeedback feedback(size_t axis) const;
+
+    /**
+     * @brief 获取已发布次数
+     */
+    uint64_t published() const { return seq_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 写入控制字（应用线程）
+     */
+    void set_control(size_t axis, uint16_t control);
+
+    /**
+     * @brief 写入目标位置（应用线程）
+     */
+    void set_target(size_t axis, int32_t position);
+
+    /**
+     * @brief 写入操作模式（应用线程）
+     */
+    void set_opmode(size_t axis, uint8_t op_mode, uint8_t resv1);
+
+    /**
+     * @brief 取走命令（总线线程）
+     * @param axis 轴索引
+     * @param out 输出命令
+     * @return true 自上次取走以来命令有变化，false 没有变化或正被写入
+     */
+    bool take(size_t axis, AxisCommand& out);
+
+private:
+    AxisMailbox(const AxisMailbox&);
+    AxisMailbox& operator=(const AxisMailbox&);
+
+    /**
+     * @brief 单轴命令槽
+     *
+     * seq为奇数表示正被写入；多个应用线程写同一轴时以CAS互斥，只在应用线程之间等待
+     */
+    struct alignas(kCacheLineSize) CommandSlot {
+        std::atomic<uint32_t> seq;  ///< 写入序号
+        AxisCommand command;        ///< 命令
+        uint32_t taken;             ///< 总线线程上次取走时的序号（仅总线线程访问）
+
+        CommandSlot() : seq(0), taken(0) {}
+    };
+
+    CommandSlot& begin_write(size_t axis);
+    void end_write(CommandSlot& slot);
+
+    AlignedArray<CommandSlot> slots_;           ///< 各轴命令槽
+    std::vector<AxisFeedback> feedback_[2];     ///< 反馈双缓冲，第k次发布写入feedback_[k & 1]
+    std::atomic<uint64_t> seq_;                 ///< 已发布次数
+};
+
+template <typename Fn>
+void AxisMailbox::read(Fn fn) const {
+    for (;;) {
+        const uint64_t seq = seq_.load(std::memory_order_acquire);
+        fn(feedback_[seq & 1].data(), feedback_[seq & 1].size());
+        // 第seq+1次发布写入另一块缓冲区，第seq+2次才会覆盖本块，而它开始之前序号已变为seq+1
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == seq) return;
+    }
+}
+
+#endif // AXIS_MAILBOX_HPP
@@ -0,0 +1,153 @@
+#ifndef AXIS_OPS_HPP
+#define AXIS_OPS_HPP
+
+/**
+ * @file axis_ops.hpp
+ * @brief 异步轴操作（使能、定位、故障复位）及其完成令牌
+ *
+ * 非实时线程提交操作后立即得到AxisOp令牌，周期循环每周期推进所有未完成的操作，
+ * 在驱动器报告目标状态（操作使能0x27、到位、故障清除）或超时时完成令牌。
+ * 提交不加锁，周期循环推进和完成操作时不加锁、不分配内存；等待方阻塞在futex上，
+ * 不需要轮询get_status()。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+#include "cia402_state_machine.hpp"
+
+class MotorApi;
+struct AxisOpState;
+
+/**
+ * @brief 操作状态
+ */
+enum class OpStatus : int {
+    Pending,    ///< 进行中
+    Done,       ///< 已达到目标状态
+    TimedOut,   ///< 超时
+    Failed,     ///< 无法执行（轴索引无效、未使能或定位中出现故障）
+    Cancelled   ///< 被取消或被同一轴上更新的操作取代
+};
+
+/**
+ * @brief 定位选项
+ */
+struct MoveOptions {
+    int32_t max_step;       ///< 每周期目标位置的最大变化量，0表示直接写入终点（由驱动器自行插补）
+    int32_t tolerance;      ///< 到位窗口：|实际位置 - 终点| <= tolerance 时完成
+    uint32_t timeout_ms;    ///< 超时（毫秒）
+
+    MoveOptions() : max_step(0), tolerance(10), timeout_ms(10000) {}
+};
+
+/**
+ * @brief 操作完成令牌
+ *
+ * 可复制，所有副本指向同一个操作；令牌全部销毁不影响操作继续执行。
+ */
+class AxisOp {
+public:
+    AxisOp();
+    AxisOp(const AxisOp& other);
+    AxisOp& operator=(const AxisOp& other);
+    ~AxisOp();
+
+    /**
+     * @brief 是否指向一个操作
+     */
+    bool valid() const { return state_ != nullptr; }
+
+    /**
+     * @brief 获取当前状态，无效令牌返回Failed
+     */
+    OpStatus status() const;
+
+    /**
+     * @brief 是否已完成（状态不再是Pending）
+     */
+    bool done() const { return status() != OpStatus::Pending; }
+
+    /**
+     * @brief 阻塞等待完成
+     * @param timeout_ms 最长等待时间（毫秒），0表示一直等待
+     * @return 完成时的状态，等待超时返回Pending（操作本身的超时由周期循环判定）
+     */
+    OpStatus wait(uint32_t timeout_ms = 0) const;
+
+    /**
+     * @brief 请求取消，周期循环在下一周期以Cancelled完成
+     */
+    void cancel();
+
+private:
+    friend class AxisOpQueue;
+    explicit AxisOp(AxisOpState* state);
+
+    AxisOpState* state_;    ///< 共享的操作状态
+};
+
+/**
+ * @brief 操作队列
+ *
+ * enable()、move()、reset_faults()可在任意线程调用；poll()只由总线线程每周期调用。
+ * 新操作取代同一轴上写同一对象的旧操作：定位取代该轴的定位，使能与复位都写控制字，互相取代。
+ */
+class AxisOpQueue {
+public:
+    AxisOpQueue();
+    ~AxisOpQueue();
+
+    /**
+     * @brief 提交使能操作
+     * @param mask 轴掩码，第m位对应第m个轴
+     * @param all_axes 为true时忽略mask，作用于全部轴
+     * @param timeout_ms 超时（毫秒）
+     * @param machines 各轴的状态机（已绑定各轴转换表），由操作独占推进，不与轴自身的状态机共用
+     */
+    AxisOp enable(uint64_t mask, bool all_axes, uint32_t timeout_ms, std::vector<Cia402StateMachine> machines);
+
+    /**
+     * @brief 提交定位操作
+     * @param axis 轴索引
+     * @param position 终点
+     * @param options 定位选项
+     */
+    AxisOp move(size_t axis, int32_t position, const MoveOptions& options);
+
+    /**
+     * @brief 提交故障复位操作
+     * @param mask 轴掩码
+     * @param timeout_ms 超时（毫秒）
+     */
+    AxisOp reset_faults(uint64_t mask, uint32_t timeout_ms);
+
+    /**
+     * @brief 推进所有未完成的操作（总线线程）
+     * @param api 电机API，通过其读写函数访问各轴
+     */
+    void poll(MotorApi& api);
+
+    /**
+     * @brief 获取未完成的操作数（总线线程）
+     */
+    size_t active() const { return active_count_; }
+
+private:
+    AxisOpQueue(const AxisOpQueue&);
+    AxisOpQueue& operator=(const AxisOpQueue&);
+
+    AxisOp submit(AxisOpState* state);
+    void adopt_incoming();
+    OpStatus step(AxisOpState& op, MotorApi& api);
+    void finish(AxisOpState* op, OpStatus status);
+    void reclaim();
+
+    std::atomic<AxisOpState*> incoming_;    ///< 新提交的操作（无锁栈，后进先出）
+    std::atomic<AxisOpState*> retired_;     ///< 已完成且令牌已全部销毁的操作，由提交方释放
+    AxisOpState* active_;                   ///< 未完成的操作链表，按提交顺序（仅总线线程访问）
+    size_t active_count_;                   ///< 未完成的操作数
+};
+
+#endif // AXIS_OPS_HPP
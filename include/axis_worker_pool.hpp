@@ -0,0 +1,102 @@
+#ifndef AXIS_WORKER_POOL_HPP
+#define AXIS_WORKER_POOL_HPP
+
+/**
+ * @file axis_worker_pool.hpp
+ * @brief 周期内的多核并行轴计算
+ *
+ * 少量绑定CPU的工作线程在每周期的屏障上自旋等待。主线程发布任务后，
+ * 轴区间按连续块划分给主线程和各工作线程（每轴的AxisBlock独占缓存行，块间无伪共享），
+ * 主线程完成自己的块后在完成计数上自旋，全部完成后由主线程统一queue_and_send()。
+ * 自旋使唤醒延迟在百纳秒级，代价是工作线程占满所绑定的CPU，应绑定到隔离核；
+ * 自旋一定次数后改为sched_yield()，线程多于空闲CPU时不至于互相饿死。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <pthread.h>
+#include "axis_data.hpp"
+
+/**
+ * @brief 工作线程池配置
+ */
+struct WorkerPoolConfig {
+    size_t workers;             ///< 工作线程数（不含主线程），0表示不并行
+    std::vector<int> cpus;      ///< 各工作线程绑定的CPU，不足的线程不绑定
+    int priority;               ///< SCHED_FIFO优先级，0表示默认调度策略
+
+    WorkerPoolConfig() : workers(0), priority(0) {}
+};
+
+/**
+ * @brief 轴计算工作线程池
+ */
+class AxisWorkerPool {
+public:
+    /**
+     * @brief 区间任务：处理[begin, end)内的轴
+     */
+    typedef std::function<void(size_t begin, size_t end)> RangeFn;
+
+    AxisWorkerPool();
+    ~AxisWorkerPool();
+
+    /**
+     * @brief 启动工作线程
+     * @param config 线程池配置
+     * @return true 全部线程启动成功，false 已在运行或线程创建失败（已启动的线程会被停止）
+     */
+    bool start(const WorkerPoolConfig& config);
+
+    /**
+     * @brief 停止并回收工作线程
+     */
+    void stop();
+
+    /**
+     * @brief 获取工作线程数（不含主线程）
+     */
+    size_t workers() const { return threads_.size(); }
+
+    /**
+     * @brief 并行处理[0, count)
+     * @param count 轴数量
+     * @param fn 区间任务，在主线程和各工作线程上以互不重叠的区间调用
+     *
+     * 返回时所有区间均已处理完毕，工作线程的写入对主线程可见。
+     * 未启动工作线程或count不大于1时在主线程上直接调用fn(0, count)。
+     * 只能由一个线程调用。
+     */
+    void run(size_t count, const RangeFn& fn);
+
+private:
+    AxisWorkerPool(const AxisWorkerPool&);
+    AxisWorkerPool& operator=(const AxisWorkerPool&);
+
+    static void* thread_entry(void* arg);
+    void worker_loop(size_t index);
+    void range_of(size_t part, size_t& begin, size_t& end) const;
+
+    struct Worker {
+        AxisWorkerPool* pool;
+        size_t index;
+    };
+
+    // 主线程写、工作线程读的发布区与工作线程写的完成计数之间用一整行填充隔开，
+    // 避免伪共享（用填充而非alignas的原因见kCacheLineSize）
+    std::atomic<uint64_t> generation_;      ///< 任务代号，递增即发布
+    const RangeFn* fn_;                     ///< 当前任务
+    size_t count_;                          ///< 当前轴数量
+    size_t parts_;                          ///< 区间块数（工作线程数+1）
+    std::atomic<bool> stop_;                ///< 停止请求
+    char pad_[kCacheLineSize];              ///< 缓存行填充
+    std::atomic<size_t> done_;              ///< 已完成的工作线程数
+
+    std::vector<pthread_t> threads_;                            ///< 工作线程
+    std::vector<Worker> workers_;                               ///< 线程参数
+};
+
+#endif // AXIS_WORKER_POOL_HPP
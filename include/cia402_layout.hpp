@@ -0,0 +1,43 @@
+#ifndef CIA402_LAYOUT_HPP
+#define CIA402_LAYOUT_HPP
+
+/**
+ * @file cia402_layout.hpp
+ * @brief 标准CiA 402 PDO布局
+ *
+ * StandardMotorAdapter与MotorApiStatic共用的PDO映射定义
+ */
+
+#include "pdo_layout.hpp"
+
+/**
+ * @brief 标准RxPDO布局（0x1600）
+ */
+typedef PdoLayout<
+    PdoEntry<0x6040, uint16_t>,  // Control word
+    PdoEntry<0x607A, int32_t>,   // Target position
+    PdoEntry<0x60FF, int32_t>,   // Target velocity
+    PdoEntry<0x6071, int16_t>,   // Target torque
+    PdoEntry<0x6060, uint8_t>,   // Operation mode
+    PdoEntry<0x60C2, uint8_t>    // Reserved 1
+> Cia402RxLayout;
+
+/**
+ * @brief 标准TxPDO布局（0x1A00）
+ */
+typedef PdoLayout<
+    PdoEntry<0x6041, uint16_t>,  // Status word
+    PdoEntry<0x6064, int32_t>,   // Actual position
+    PdoEntry<0x606C, int32_t>,   // Actual velocity
+    PdoEntry<0x6077, int16_t>,   // Actual torque
+    PdoEntry<0x6061, uint8_t>,   // Operation mode display
+    PdoEntry<0x603F, uint16_t>,  // Error code
+    PdoEntry<0x2026, uint8_t>    // Reserved 2
+> Cia402TxLayout;
+
+/**
+ * @brief 标准PDO映射
+ */
+typedef PdoMapping<0x1600, Cia402RxLayout, 0x1A00, Cia402TxLayout> Cia402Mapping;
+
+#endif // CIA402_LAYOUT_HPP
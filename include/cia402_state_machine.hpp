@@ -0,0 +1,224 @@
+#ifndef CIA402_STATE_MACHINE_HPP
+#define CIA402_STATE_MACHINE_HPP
+
+/**
+ * @file cia402_state_machine.hpp
+ * @brief 表驱动的CiA 402状态机
+ *
+ * 状态字经掩码后查表得到当前状态与应输出的控制字。转换表为编译期常量，
+ * 厂家差异以表项补丁的形式叠加；每个轴持有独立的状态机对象，
+ * 去抖计数与故障复位计数互不影响，周期内无内存分配、无打印。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief CiA 402驱动器状态
+ */
+enum class Cia402State : uint8_t {
+    NotReadyToSwitchOn,     ///< 未准备好接通
+    SwitchOnDisabled,       ///< 接通禁止
+    ReadyToSwitchOn,        ///< 准备接通
+    SwitchedOn,             ///< 已接通
+    OperationEnabled,       ///< 操作使能
+    QuickStopActive,        ///< 快速停止
+    FaultReactionActive,    ///< 故障响应
+    Fault,                  ///< 故障
+    Unknown                 ///< 无法识别
+};
+
+/**
+ * @brief 转换表项标志
+ */
+enum : uint8_t {
+    kCia402RunEnable = 0x01,        ///< 该状态下允许运行（更新目标）
+    kCia402CountFault = 0x02,       ///< 计入故障复位次数
+    kCia402ClearFaultCount = 0x04   ///< 清零故障复位次数
+};
+
+/**
+ * @brief 状态转换表项
+ *
+ * (status & mask) == value 时命中，输出control并按flags更新运行标志与计数
+ */
+struct Cia402Transition {
+    uint16_t mask;          ///< 状态字掩码
+    uint16_t value;         ///< 掩码后的匹配值
+    Cia402State state;      ///< 对应状态
+    uint16_t control;       ///< 输出控制字
+    uint8_t flags;          ///< kCia402RunEnable等标志组合
+};
+
+/**
+ * @brief 标准CiA 402转换表
+ *
+ * 告警位(0x0080)不参与匹配，带告警的状态按其基本状态推进
+ */
+constexpr Cia402Transition kCia402StandardTable[] = {
+    {0x004F, 0x0000, Cia402State::NotReadyToSwitchOn, 0x0006, 0},
+    {0x004F, 0x0040, Cia402State::SwitchOnDisabled, 0x0006, 0},
+    {0x006F, 0x0021, Cia402State::ReadyToSwitchOn, 0x0007, 0},
+    {0x006F, 0x0023, Cia402State::SwitchedOn, 0x000F, 0},
+    {0x006F, 0x0027, Cia402State::OperationEnabled, 0x000F, kCia402RunEnable | kCia402ClearFaultCount},
+    {0x006F, 0x0007, Cia402State::QuickStopActive, 0x0000, 0},
+    {0x004F, 0x000F, Cia402State::FaultReactionActive, 0x0000, 0},
+    {0x004F, 0x0008, Cia402State::Fault, 0x0080, kCia402CountFault},
+};
+
+/**
+ * @brief 未命中任何表项时的输出
+ */
+constexpr Cia402Transition kCia402Fallback = {0x0000, 0x0000, Cia402State::Unknown, 0x0006, 0};
+
+/**
+ * @brief CiA 402转换表
+ *
+ * 以标准表为基础，通过patch()叠加厂家补丁。掩码只涉及低7位的表项
+ * 预先展开为128项查找表，涉及高位（如故障代码字节）的补丁在查找表之前匹配。
+ */
+class Cia402Table {
+public:
+    static const size_t kMaxRows = 16;       ///< 表项容量
+    static const size_t kMaxOverrides = 8;   ///< 高位补丁容量
+
+    /**
+     * @brief 以标准表构造
+     */
+    Cia402Table();
+
+    /**
+     * @brief 叠加补丁表项
+     * @param row 补丁表项，优先级高于已有表项
+     * @return true 成功，false 容量不足
+     */
+    bool patch(const Cia402Transition& row);
+
+    /**
+     * @brief 查找状态字对应的表项
+     * @param status 状态字
+     * @return 命中的表项
+     */
+    const Cia402Transition& lookup(uint16_t status) const {
+        for (size_t i = 0; i < override_count_; ++i) {
+            if ((status & overrides_[i].mask) == overrides_[i].value) return overrides_[i];
+        }
+        return rows_[lut_[status & 0x7F]];
+    }
+
+    /**
+     * @brief 获取标准表实例
+     * @return 标准CiA 402转换表
+     */
+    static const Cia402Table& standard();
+
+    uint16_t settle_cycles;         ///< 状态字变化后保持上次控制字的周期数，0表示不去抖
+    uint16_t fault_reset_limit;     ///< 连续故障复位次数上限，0表示不限
+    uint16_t fault_escape_control;  ///< 达到复位上限后输出的控制字
+
+private:
+    /**
+     * @brief 根据rows_重建低7位查找表
+     */
+    void rebuild();
+
+    Cia402Transition rows_[kMaxRows + 1];           ///< 基本表项，末尾为未命中项
+    size_t row_count_;                              ///< 基本表项数量（不含未命中项）
+    Cia402Transition overrides_[kMaxOverrides];     ///< 高位补丁
+    size_t override_count_;                         ///< 高位补丁数量
+    uint8_t lut_[128];                              ///< 低7位到表项下标的映射
+};
+
+/**
+ * @brief 单轴CiA 402状态机
+ *
+ * 每个轴一个实例，保存当前状态、去抖计数与故障复位计数
+ */
+class Cia402StateMachine {
+public:
+    /**
+     * @brief 使用标准表构造
+     */
+    Cia402StateMachine() { bind(Cia402Table::standard()); }
+
+    /**
+     * @brief 使用指定表构造
+     * @param table 转换表，生命周期须长于状态机
+     */
+    explicit Cia402StateMachine(const Cia402Table& table) { bind(table); }
+
+    /**
+     * @brief 绑定转换表并复位内部状态
+     * @param table 转换表，生命周期须长于状态机
+     */
+    void bind(const Cia402Table& table) {
+        table_ = &table;
+        reset();
+    }
+
+    /**
+     * @brief 复位内部状态
+     */
+    void reset() {
+        state_ = Cia402State::Unknown;
+        last_status_ = 0;
+        last_control_ = 0;
+        settle_ = 0;
+        fault_resets_ = 0;
+    }
+
+    /**
+     * @brief 推进一个周期
+     * @param status 当前状态字
+     * @param run_enable 运行使能标志引用，去抖期间保持不变
+     * @return 本周期应写入的控制字
+     */
+    uint16_t step(uint16_t status, bool &run_enable) {
+        if (status != last_status_) {
+            last_status_ = status;
+            settle_ = 0;
+        } else if (settle_ < 0xFFFF) {
+            ++settle_;
+        }
+        if (settle_ < table_->settle_cycles) {
+            return last_control_;
+        }
+
+        const Cia402Transition& t = table_->lookup(status);
+        uint16_t control = t.control;
+        if (t.flags & kCia402ClearFaultCount) {
+            fault_resets_ = 0;
+        }
+        if ((t.flags & kCia402CountFault) && table_->fault_reset_limit &&
+            ++fault_resets_ >= table_->fault_reset_limit) {
+            fault_resets_ = 0;
+            control = table_->fault_escape_control;
+        }
+        state_ = t.state;
+        run_enable = (t.flags & kCia402RunEnable) != 0;
+        last_control_ = control;
+        return control;
+    }
+
+    /**
+     * @brief 获取最近一次识别的状态
+     * @return 驱动器状态
+     */
+    Cia402State state() const { return state_; }
+
+    /**
+     * @brief 获取最近一次输出的控制字
+     * @return 控制字
+     */
+    uint16_t last_control() const { return last_control_; }
+
+private:
+    const Cia402Table* table_;   ///< 转换表
+    Cia402State state_;          ///< 当前状态
+    uint16_t last_status_;       ///< 上次状态字
+    uint16_t last_control_;      ///< 上次输出的控制字
+    uint16_t settle_;            ///< 状态字保持不变的周期数
+    uint16_t fault_resets_;      ///< 连续故障复位次数
+};
+
+#endif // CIA402_STATE_MACHINE_HPP
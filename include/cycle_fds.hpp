@@ -0,0 +1,116 @@
+#ifndef CYCLE_FDS_HPP
+#define CYCLE_FDS_HPP
+
+/**
+ * @file cycle_fds.hpp
+ * @brief 供外部事件循环使用的周期定时器与完成通知文件描述符
+ *
+ * CycleTimerFd封装按周期到期的timerfd，CycleEventFd封装eventfd计数器。
+ * 两者均为非阻塞描述符，可直接加入已有的epoll/poll事件循环：定时器可读时
+ * 驱动一个总线周期，完成通知可读时读取新的输入，不需要额外线程和usleep。
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief 周期定时器（timerfd）
+ */
+class CycleTimerFd {
+public:
+    CycleTimerFd();
+    ~CycleTimerFd();
+
+    /**
+     * @brief 创建并启动定时器
+     * @param period_ns 周期（纳秒）
+     * @return true 成功，false 已打开或创建失败
+     *
+     * 在CLOCK_MONOTONIC上以当前时间加一个周期为首个截止时间，之后按绝对周期到期，
+     * 处理延迟不会累积到周期上
+     */
+    bool open(uint64_t period_ns);
+
+    /**
+     * @brief 关闭定时器
+     */
+    void close();
+
+    /**
+     * @brief 获取描述符，未打开时为-1
+     */
+    int fd() const { return fd_; }
+
+    /**
+     * @brief 非阻塞读取自上次读取以来的到期次数
+     * @return 到期次数，尚未到期或未打开时为0
+     *
+     * 大于1表示事件循环没能及时处理，错过了到期次数-1个周期
+     */
+    uint64_t read();
+
+    /**
+     * @brief 获取最近一次到期对应的截止时间（CLOCK_MONOTONIC纳秒）
+     */
+    uint64_t deadline_ns() const { return start_ns_ + expirations_ * period_ns_; }
+
+    /**
+     * @brief 获取打开以来的累计到期次数
+     */
+    uint64_t expirations() const { return expirations_; }
+
+private:
+    CycleTimerFd(const CycleTimerFd&);
+    CycleTimerFd& operator=(const CycleTimerFd&);
+
+    int fd_;                    ///< timerfd描述符
+    uint64_t period_ns_;        ///< 周期
+    uint64_t start_ns_;         ///< 启动时间，第k次到期的截止时间为start_ns_ + k * period_ns_
+    uint64_t expirations_;      ///< 累计到期次数
+};
+
+/**
+ * @brief 周期完成通知（eventfd）
+ *
+ * 每次signal()使计数加1，描述符在计数非零时可读。signal()只有一次write系统调用，
+ * 可在周期线程中调用；消费方在任意线程通过drain()读取并清零。
+ */
+class CycleEventFd {
+public:
+    CycleEventFd();
+    ~CycleEventFd();
+
+    /**
+     * @brief 创建eventfd
+     * @return true 成功，false 已打开或创建失败
+     */
+    bool open();
+
+    /**
+     * @brief 关闭eventfd
+     */
+    void close();
+
+    /**
+     * @brief 获取描述符，未打开时为-1
+     */
+    int fd() const { return fd_; }
+
+    /**
+     * @brief 计数加1，未打开时不做任何事
+     */
+    void signal();
+
+    /**
+     * @brief 非阻塞读取并清零计数
+     * @return 自上次读取以来的通知次数，没有新通知时为0
+     */
+    uint64_t drain();
+
+private:
+    CycleEventFd(const CycleEventFd&);
+    CycleEventFd& operator=(const CycleEventFd&);
+
+    int fd_;    ///< eventfd描述符
+};
+
+#endif // CYCLE_FDS_HPP
@@ -0,0 +1,133 @@
+#ifndef CYCLE_HOOKS_HPP
+#define CYCLE_HOOKS_HPP
+
+/**
+ * @file cycle_hooks.hpp
+ * @brief 周期钩子流水线
+ *
+ * 轨迹回放、安全限位、数据记录、遥测发布等模块按阶段注册有序钩子，
+ * run_cyclic()在固定位置依次调用，应用不必各自重写收发循环。
+ * 每个钩子单独计时，可直接看出周期预算消耗在哪个模块上。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "cycle_stats.hpp"
+
+class MotorApi;
+
+/**
+ * @brief 钩子所在的周期阶段
+ */
+enum class HookPhase {
+    PreReceive,     ///< 接收之前
+    PostProcess,    ///< 接收与域处理之后、用户回调之前
+    PreSend,        ///< 用户回调之后、发送之前
+};
+
+/**
+ * @brief 周期钩子流水线
+ */
+class CycleHooks {
+public:
+    static const size_t kPhases = 3;    ///< 阶段数
+
+    /**
+     * @brief 钩子函数
+     * @param api 电机接口
+     * @param cycle 周期号
+     * @return true 继续，false 结束周期循环（与周期回调返回false相同）
+     */
+    typedef std::function<bool(MotorApi& api, uint64_t cycle)> Hook;
+
+    /**
+     * @brief 钩子信息与耗时统计
+     */
+    struct HookInfo {
+        std::string name;       ///< 钩子名
+        HookPhase phase;        ///< 所在阶段
+        int order;              ///< 执行顺序，小的先执行
+        uint64_t runs;          ///< 执行次数
+        uint64_t last_ns;       ///< 最近一次耗时
+    };
+
+    /**
+     * @brief 注册钩子
+     * @param phase 所在阶段
+     * @param name 钩子名
+     * @param hook 钩子函数
+     * @param order 执行顺序，小的先执行，相同时按注册顺序
+     *
+     * 应在周期循环开始前注册
+     */
+    void add(HookPhase phase, const std::string& name, const Hook& hook, int order = 0);
+
+    /**
+     * @brief 移除所有钩子
+     */
+    void clear();
+
+    /**
+     * @brief 依次执行某阶段的钩子
+     * @param phase 阶段
+     * @param api 电机接口
+     * @param cycle 周期号
+     * @return true 全部钩子返回true，false 某个钩子返回false（其后的钩子不再执行）
+     *
+     * 自行编写收发循环时，可在相应位置调用以复用已注册的模块
+     */
+    bool run(HookPhase phase, MotorApi& api, uint64_t cycle);
+
+    /**
+     * @brief 获取某阶段的钩子数量
+     */
+    size_t size(HookPhase phase) const { return hooks_[index_of(phase)].size(); }
+
+    /**
+     * @brief 获取钩子信息
+     * @param phase 阶段
+     * @param index 按执行顺序的索引
+     */
+    const HookInfo& info(HookPhase phase, size_t index) const { return hooks_[index_of(phase)][index].info; }
+
+    /**
+     * @brief 获取钩子耗时分布
+     * @param phase 阶段
+     * @param index 按执行顺序的索引
+     */
+    const LatencyHistogram& timing(HookPhase phase, size_t index) const {
+        return *hooks_[index_of(phase)][index].timing;
+    }
+
+    /**
+     * @brief 清空所有钩子的耗时统计
+     */
+    void reset_timing();
+
+    /**
+     * @brief 打印各钩子的耗时摘要
+     */
+    void print_timing() const;
+
+    /**
+     * @brief 获取阶段名
+     */
+    static const char* phase_name(HookPhase phase);
+
+private:
+    struct Entry {
+        HookInfo info;
+        Hook fn;
+        std::unique_ptr<LatencyHistogram> timing;   ///< 直方图含原子计数不可移动，单独分配
+    };
+
+    static size_t index_of(HookPhase phase) { return static_cast<size_t>(phase); }
+
+    std::vector<Entry> hooks_[kPhases];     ///< 各阶段的钩子，按执行顺序排列
+};
+
+#endif // CYCLE_HOOKS_HPP
@@ -0,0 +1,198 @@
+#ifndef CYCLE_STATS_HPP
+#define CYCLE_STATS_HPP
+
+/**
+ * @file cycle_stats.hpp
+ * @brief 周期耗时统计
+ *
+ * 对数线性直方图：每个2的幂区间再等分为16个子桶，相对误差不超过1/16，
+ * 覆盖1ns到约18分钟。记录只有几次无锁原子操作，可在周期内常开；
+ * 其他线程可随时读取分位数而不需要加锁。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * @brief 直方图摘要（单位：纳秒）
+ */
+struct HistogramSummary {
+    uint64_t count;     ///< 样本数
+    uint64_t min;       ///< 最小值
+    uint64_t max;       ///< 最大值
+    uint64_t mean;      ///< 平均值
+    uint64_t p50;       ///< 50分位
+    uint64_t p90;       ///< 90分位
+    uint64_t p99;       ///< 99分位
+    uint64_t p999;      ///< 99.9分位
+};
+
+/**
+ * @brief 无锁对数线性直方图
+ */
+class LatencyHistogram {
+public:
+    static const unsigned kSubBits = 4;                             ///< 每个2的幂区间的子桶位数
+    static const unsigned kSubBuckets = 1u << kSubBits;             ///< 每个区间的子桶数
+    static const unsigned kMaxExp = 40;                             ///< 可区分的最高次幂
+    static const size_t kBuckets = (kMaxExp - kSubBits + 2) * kSubBuckets;  ///< 桶数量
+
+    LatencyHistogram() { reset(); }
+
+    /**
+     * @brief 记录一个样本
+     * @param value 样本值（纳秒），超出范围的值计入最后一个桶
+     */
+    void record(uint64_t value) {
+        counts_[index_of(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t cur = min_.load(std::memory_order_relaxed);
+        while (value < cur && !min_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+        }
+        cur = max_.load(std::memory_order_relaxed);
+        while (value > cur && !max_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief 清空所有样本
+     *
+     * 与record()并发时个别样本可能被计入或丢弃，统计仍保持一致可读
+     */
+    void reset() {
+        for (size_t i = 0; i < kBuckets; ++i) counts_[i].store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取样本数
+     */
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 获取最小值，无样本时为0
+     */
+    uint64_t min() const {
+        uint64_t v = min_.load(std::memory_order_relaxed);
+        return v == UINT64_MAX ? 0 : v;
+    }
+
+    /**
+     * @brief 获取最大值
+     */
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 获取平均值
+     */
+    uint64_t mean() const {
+        uint64_t n = count();
+        return n ? sum_.load(std::memory_order_relaxed) / n : 0;
+    }
+
+    /**
+     * @brief 获取分位数
+     * @param percent 百分位（0-100）
+     * @return 所在桶的上界，不超过最大值
+     */
+    uint64_t percentile(double percent) const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBuckets; ++i) total += counts_[i].load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+
+        uint64_t rank = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(total) + 0.5);
+        if (rank == 0) rank = 1;
+        if (rank > total) rank = total;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t upper = upper_bound_of(i);
+                uint64_t hi = max();
+                return upper < hi ? upper : hi;
+            }
+        }
+        return max();
+    }
+
+    /**
+     * @brief 生成摘要
+     */
+    HistogramSummary summary() const {
+        HistogramSummary s;
+        s.count = count();
+        s.min = min();
+        s.max = max();
+        s.mean = mean();
+        s.p50 = percentile(50.0);
+        s.p90 = percentile(90.0);
+        s.p99 = percentile(99.0);
+        s.p999 = percentile(99.9);
+        return s;
+    }
+
+    /**
+     * @brief 计算样本所在的桶
+     */
+    static size_t index_of(uint64_t value) {
+        if (value < kSubBuckets) return static_cast<size_t>(value);
+        unsigned exp = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        if (exp > kMaxExp) return kBuckets - 1;
+        unsigned sub = static_cast<unsigned>(value >> (exp - kSubBits)) & (kSubBuckets - 1);
+        return (exp - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    /**
+     * @brief 计算桶的上界（包含）
+     */
+    static uint64_t upper_bound_of(size_t index) {
+        if (index < kSubBuckets) return index;
+        unsigned exp = static_cast<unsigned>(index / kSubBuckets) + kSubBits - 1;
+        uint64_t sub = index % kSubBuckets;
+        uint64_t width = 1ULL << (exp - kSubBits);
+        return ((kSubBuckets + sub) << (exp - kSubBits)) + width - 1;
+    }
+
+private:
+    LatencyHistogram(const LatencyHistogram&);
+    LatencyHistogram& operator=(const LatencyHistogram&);
+
+    std::atomic<uint64_t> counts_[kBuckets];    ///< 各桶计数
+    std::atomic<uint64_t> count_;               ///< 样本数
+    std::atomic<uint64_t> sum_;                 ///< 样本和
+    std::atomic<uint64_t> min_;                 ///< 最小值
+    std::atomic<uint64_t> max_;                 ///< 最大值
+};
+
+/**
+ * @brief 周期各阶段耗时统计
+ */
+struct CycleStats {
+    LatencyHistogram wakeup;    ///< 唤醒延迟：实际唤醒时间与截止时间之差（仅run_cyclic）
+    LatencyHistogram receive;   ///< receive_and_process()耗时
+    LatencyHistogram compute;   ///< 接收结束到queue_and_send()开始之间的用户计算耗时
+    LatencyHistogram send;      ///< queue_and_send()耗时
+    LatencyHistogram period;    ///< 相邻两次receive_and_process()开始时间之差
+    LatencyHistogram send_jitter; ///< 实际发送时刻晚于计划发送时刻的量（仅run_cyclic）
+
+    /**
+     * @brief 清空所有阶段的统计
+     */
+    void reset() {
+        wakeup.reset();
+        receive.reset();
+        compute.reset();
+        send.reset();
+        period.reset();
+        send_jitter.reset();
+    }
+};
+
+#endif // CYCLE_STATS_HPP
@@ -0,0 +1,142 @@
+#ifndef CYCLE_WATCHDOG_HPP
+#define CYCLE_WATCHDOG_HPP
+
+/**
+ * @file cycle_watchdog.hpp
+ * @brief 周期循环的带外看门狗
+ *
+ * 周期线程每周期发布一次心跳（一次原子存储），独立的低优先级监督线程按
+ * 检查周期读取心跳。心跳间隔超过停滞时限时调用停滞处理函数，恢复后记录
+ * 本次停滞的时长。周期线程因缺页、优先级反转、阻塞输出等停住时，
+ * 行为变得有界且可观测，而不是等到从站EtherCAT看门狗超时。
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <pthread.h>
+#include "cycle_stats.hpp"
+
+/**
+ * @brief 看门狗配置
+ */
+struct WatchdogConfig {
+    uint32_t check_period_us;   ///< 检查周期（微秒）
+    uint32_t stall_timeout_us;  ///< 停滞时限（微秒），心跳间隔超过该值视为停滞
+    int priority;               ///< SCHED_FIFO优先级，应低于周期线程；0表示默认调度策略
+    int cpu;                    ///< 绑定的CPU编号，-1表示不绑定
+
+    WatchdogConfig() : check_period_us(1000), stall_timeout_us(10000), priority(0), cpu(-1) {}
+};
+
+/**
+ * @brief 周期看门狗
+ */
+class CycleWatchdog {
+public:
+    /**
+     * @brief 停滞处理函数
+     *
+     * 参数依次为当前停滞时长（纳秒）、是否为本次停滞的首次回调。
+     * 在看门狗线程中调用，停滞持续期间每个检查周期调用一次。
+     */
+    typedef std::function<void(uint64_t stall_ns, bool first)> StallHandler;
+
+    CycleWatchdog();
+    ~CycleWatchdog();
+
+    /**
+     * @brief 启动监督线程
+     * @param config 看门狗配置
+     * @param handler 停滞处理函数
+     * @return true 启动成功，false 已在运行或线程创建失败
+     *
+     * 只在arm()与disarm()之间检查心跳；布防状态与启动先后无关，
+     * 周期循环已在运行时启动，立即开始监督
+     */
+    bool start(const WatchdogConfig& config, const StallHandler& handler);
+
+    /**
+     * @brief 停止监督线程并等待退出
+     */
+    void stop();
+
+    /**
+     * @brief 是否正在运行
+     */
+    bool running() const { return running_; }
+
+    /**
+     * @brief 布防：周期循环开始时调用，此后心跳停滞超过时限视为停滞
+     * @param now_ns CLOCK_MONOTONIC纳秒时间，作为最近一次心跳
+     */
+    void arm(uint64_t now_ns);
+
+    /**
+     * @brief 撤防：周期循环结束时调用，循环之外的停顿不再视为停滞
+     */
+    void disarm() { armed_.store(false, std::memory_order_release); }
+
+    /**
+     * @brief 是否已布防
+     */
+    bool armed() const { return armed_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 发布心跳
+     * @param now_ns CLOCK_MONOTONIC纳秒时间
+     *
+     * 由周期线程每周期调用，只有两次无锁原子存储
+     */
+    void beat(uint64_t now_ns) {
+        last_beat_ns_.store(now_ns, std::memory_order_release);
+        beats_.store(beats_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取心跳次数
+     */
+    uint64_t beats() const { return beats_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 当前是否处于停滞
+     */
+    bool stalled() const { return stalled_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 获取检测到的停滞次数
+     */
+    uint64_t stall_count() const { return stalls_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 获取已恢复的停滞时长分布（纳秒）
+     */
+    const LatencyHistogram& stall_durations() const { return stall_durations_; }
+
+    /**
+     * @brief 获取看门狗观察到的最大心跳间隔（纳秒）
+     */
+    uint64_t max_gap_ns() const { return max_gap_ns_.load(std::memory_order_relaxed); }
+
+private:
+    CycleWatchdog(const CycleWatchdog&);
+    CycleWatchdog& operator=(const CycleWatchdog&);
+
+    static void* thread_entry(void* arg);
+    void run();
+
+    WatchdogConfig config_;                 ///< 看门狗配置
+    StallHandler handler_;                  ///< 停滞处理函数
+    pthread_t thread_;                      ///< 监督线程
+    bool running_;                          ///< 监督线程是否已启动
+    std::atomic<bool> stop_;                ///< 停止请求
+    std::atomic<bool> armed_;               ///< 是否检查心跳
+    std::atomic<uint64_t> last_beat_ns_;    ///< 最近一次心跳时间
+    std::atomic<uint64_t> beats_;           ///< 心跳次数
+    std::atomic<bool> stalled_;             ///< 当前是否停滞
+    std::atomic<uint64_t> max_gap_ns_;      ///< 最大心跳间隔
+    std::atomic<uint64_t> stalls_;          ///< 检测到的停滞次数
+    LatencyHistogram stall_durations_;      ///< 已恢复的停滞时长
+};
+
+#endif // CYCLE_WATCHDOG_HPP
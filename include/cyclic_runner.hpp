@@ -0,0 +1,215 @@
+#ifndef CYCLIC_RUNNER_HPP
+#define CYCLIC_RUNNER_HPP
+
+/**
+ * @file cyclic_runner.hpp
+ * @brief 实时周期调度器
+ *
+ * 以CLOCK_MONOTONIC上的绝对截止时间推进周期，每个周期用
+ * clock_nanosleep(TIMER_ABSTIME)睡眠到下一截止时间，计算耗时与调度延迟
+ * 不会累积到周期上，长时间运行周期保持锁定。
+ * 可选设置SCHED_FIFO优先级、CPU亲和性、mlockall与栈预触碰。
+ *
+ * 亚毫秒周期可启用混合等待：先睡眠到截止时间前spin_margin_ns，再在
+ * CLOCK_MONOTONIC（vDSO读取TSC，不陷入内核）上自旋到截止时间，消除睡眠唤醒抖动；
+ * send_offset_ns使帧在周期内的固定时刻发出。
+ *
+ * 流水线模式下接收后立即发出上一周期计算好的设定值，再计算下一帧的设定值，
+ * 帧发出时刻与计算耗时无关，代价是设定值晚一个周期生效。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <signal.h>
+
+/**
+ * @brief 自旋等待提示，降低自旋对超线程兄弟核的干扰
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief 周期超时（上一周期的工作越过了本周期截止时间）后的降级策略
+ */
+enum class OverrunPolicy {
+    RunCallback,    ///< 照常执行用户回调，只计数
+    ResendLast,     ///< 跳过用户回调，重发上一周期的控制字与目标位置
+    HoldPosition,   ///< 跳过用户回调，目标位置保持在实际位置
+    Extrapolate     ///< 跳过用户回调，按上一周期的目标增量外推目标位置
+};
+
+/**
+ * @brief 实时配置
+ */
+struct RtConfig {
+    uint32_t period_ns;         ///< 周期（纳秒）
+    int priority;               ///< SCHED_FIFO优先级，0表示不修改调度策略
+    int cpu;                    ///< 绑定的CPU编号，-1表示不绑定
+    bool lock_memory;           ///< 是否mlockall(MCL_CURRENT | MCL_FUTURE)
+    size_t prefault_stack;      ///< 预触碰的栈字节数，0表示不预触碰
+    uint32_t spin_margin_ns;    ///< 截止时间前改为自旋的提前量，0表示只睡眠
+    uint32_t send_offset_ns;    ///< 发送时刻相对周期起点的偏移，0表示计算完成后立即发送
+    OverrunPolicy overrun_policy;   ///< 周期超时后的降级策略
+    uint32_t overrun_stop_after;    ///< 连续超时达到该次数时执行受控停机，0表示不停机
+    bool pipelined;             ///< 流水线模式：先发送上一周期的设定值，再计算下一周期的设定值
+
+    RtConfig()
+        : period_ns(1000000), priority(0), cpu(-1), lock_memory(false), prefault_stack(0),
+          spin_margin_ns(0), send_offset_ns(0), overrun_policy(OverrunPolicy::RunCallback),
+          overrun_stop_after(0), pipelined(false) {}
+
+    /**
+     * @brief 按微秒周期构造
+     * @param period_us 周期（微秒）
+     */
+    explicit RtConfig(uint32_t period_us)
+        : period_ns(period_us * 1000u), priority(0), cpu(-1), lock_memory(false), prefault_stack(0),
+          spin_margin_ns(0), send_offset_ns(0), overrun_policy(OverrunPolicy::RunCallback),
+          overrun_stop_after(0), pipelined(false) {}
+};
+
+/**
+ * @brief 实时周期调度器
+ *
+ * 典型用法：
+ * @code
+ * CyclicRunner runner(config);
+ * runner.apply_realtime();
+ * runner.start();
+ * while (running) {
+ *     runner.wait_next();
+ *     // 周期任务
+ * }
+ * @endcode
+ */
+class CyclicRunner {
+public:
+    /**
+     * @brief 构造调度器
+     * @param config 实时配置
+     */
+    explicit CyclicRunner(const RtConfig& config);
+
+    /**
+     * @brief 在调用线程上应用实时配置
+     * @return true 所有请求的设置均成功，false 至少一项失败（其余项仍会应用）
+     */
+    bool apply_realtime();
+
+    /**
+     * @brief 以当前时间为起点开始计时
+     *
+     * 第一个截止时间为当前时间加一个周期
+     */
+    void start();
+
+    /**
+     * @brief 睡眠到下一个截止时间
+     *
+     * 若已错过一个或多个截止时间，跳过错过的周期并对齐到下一个周期边界，
+     * 周期相位保持不变
+     */
+    void wait_next();
+
+    /**
+     * @brief 检查本周期是否由超时进入
+     * @return true 上一周期的工作越过了本周期截止时间，或唤醒晚于一个周期以上
+     */
+    bool overrun() const { return consecutive_overruns_ != 0; }
+
+    /**
+     * @brief 获取连续超时的周期数
+     * @return 截至本周期连续超时的次数，按时进入的周期清零
+     */
+    uint32_t consecutive_overruns() const { return consecutive_overruns_; }
+
+    /**
+     * @brief 获取超时总次数
+     * @return 自start()以来超时的周期数
+     */
+    uint64_t overruns() const { return overruns_; }
+
+    /**
+     * @brief 等待到指定的绝对时间
+     * @param abs_ns CLOCK_MONOTONIC纳秒时间，已过去时立即返回
+     *
+     * 按spin_margin_ns先睡眠再自旋
+     */
+    void wait_until(uint64_t abs_ns) const;
+
+    /**
+     * @brief 获取当前周期的起点
+     * @return 最近一次wait_next()等待到的截止时间
+     */
+    uint64_t cycle_start_ns() const { return cycle_start_; }
+
+    /**
+     * @brief 获取当前周期的计划发送时刻
+     * @return 周期起点加send_offset_ns
+     */
+    uint64_t send_time_ns() const { return cycle_start_ + config_.send_offset_ns; }
+
+    /**
+     * @brief 获取下一周期的截止时间
+     * @return CLOCK_MONOTONIC纳秒时间
+     */
+    uint64_t deadline_ns() const { return deadline_; }
+
+    /**
+     * @brief 获取已执行的周期数
+     * @return 周期数
+     */
+    uint64_t cycles() const { return cycles_; }
+
+    /**
+     * @brief 获取跳过的周期数
+     * @return 因超时而跳过的截止时间数量
+     */
+    uint64_t missed() const { return missed_; }
+
+    /**
+     * @brief 获取实时配置
+     * @return 实时配置
+     */
+    const RtConfig& config() const { return config_; }
+
+    /**
+     * @brief 获取CLOCK_MONOTONIC当前时间
+     * @return 纳秒时间
+     */
+    static uint64_t now_ns();
+
+private:
+    RtConfig config_;       ///< 实时配置
+    uint64_t deadline_;     ///< 下一截止时间
+    uint64_t cycle_start_;  ///< 当前周期起点
+    uint64_t cycles_;       ///< 已执行的周期数
+    uint64_t missed_;       ///< 跳过的周期数
+    uint64_t overruns_;     ///< 超时的周期数
+    uint32_t consecutive_overruns_;  ///< 连续超时的周期数
+};
+
+/**
+ * @brief 在作用域内屏蔽调用线程的SIGINT
+ *
+ * 库内部线程（总线线程、看门狗、工作线程）在此作用域内创建，继承屏蔽字，
+ * SIGINT只投递给应用线程，信号处理函数不会打断持有总线的实时循环
+ */
+class SigintBlockScope {
+public:
+    SigintBlockScope();
+    ~SigintBlockScope();
+
+private:
+    SigintBlockScope(const SigintBlockScope&);
+    SigintBlockScope& operator=(const SigintBlockScope&);
+
+    sigset_t saved_;    ///< 进入作用域前的屏蔽字
+};
+
+#endif // CYCLIC_RUNNER_HPP
@@ -6,6 +6,8 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include "cia402_layout.hpp"
+#include "cia402_state_machine.hpp"
 
 /**
  * @brief 电机适配器基类
@@ -73,6 +75,15 @@ public:
    */
   virtual uint16_t makeControl(uint16_t status, int32_t &start_pos, bool &run_enable) const = 0;
 
+  /**
+   * @brief 获取CiA 402状态转换表
+   * @return 转换表，生命周期与程序相同
+   *
+   * MotorApi为每个轴创建一个Cia402StateMachine并绑定该表，
+   * 厂家差异通过在标准表上叠加补丁表达
+   */
+  virtual const Cia402Table& stateTable() const = 0;
+
   /**
    * @brief 获取电机信息
    * @return 电机基本信息结构体
@@ -101,7 +112,7 @@ public:
     /**
      * @brief 从PDO数据读取电机状态
      * @param domain_pd 域过程数据指针
-     * @param offset PDO偏移量数组
+     * @param offset PDO偏移量数组（先RxPDO后TxPDO，与注册顺序一致）
      * @return 电机状态
      */
     virtual MotorStatus readStatus(const uint8_t* domain_pd, const std::vector<unsigned int>& offset) const = 0;
@@ -109,12 +120,49 @@ public:
     /**
      * @brief 将控制数据写入PDO
      * @param domain_pd 域过程数据指针
-     * @param offset PDO偏移量数组
+     * @param offset PDO偏移量数组（先RxPDO后TxPDO，与注册顺序一致）
      * @param control 控制数据
      */
     virtual void writeControl(uint8_t* domain_pd, const std::vector<unsigned int>& offset, 
                              const MotorControl& control) const = 0;
 
+    /**
+     * @brief 批量读取电机状态
+     * @param domain_pd 域过程数据指针
+     * @param offsets 每个轴的PDO偏移量数组指针，共count个
+     * @param count 轴数量
+     * @param out 输出状态数组，共count个
+     *
+     * MotorApi按适配器将轴分组后对每组调用一次。默认实现逐轴调用readStatus()，
+     * 适配器可重写为不含虚调用的批处理内核
+     */
+    virtual void decodeBatch(const uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                             size_t count, MotorStatus* out) const;
+
+    /**
+     * @brief 批量写入控制数据
+     * @param domain_pd 域过程数据指针
+     * @param offsets 每个轴的PDO偏移量数组指针，共count个
+     * @param count 轴数量
+     * @param in 控制数据数组，共count个
+     *
+     * 默认实现逐轴调用writeControl()
+     */
+    virtual void encodeBatch(uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                             size_t count, const MotorControl* in) const;
+
+    /**
+     * @brief 批量生成控制字
+     * @param status 状态字数组，共count个
+     * @param count 轴数量
+     * @param control 输出控制字数组
+     * @param run_enable 输出运行使能标志数组
+     *
+     * 无状态转换，与makeControl()一致；默认实现逐轴调用makeControl()
+     */
+    virtual void makeControlBatch(const uint16_t* status, size_t count,
+                                  uint16_t* control, bool* run_enable) const;
+
     /**
      * @brief 生成控制字
      * @param current_status 当前状态字
@@ -188,6 +236,49 @@ private:
  */
 class StandardMotorAdapter : public MotorAdapter {
 public:
+    typedef Cia402RxLayout RxLayout;   ///< 标准RxPDO布局（0x1600）
+    typedef Cia402TxLayout TxLayout;   ///< 标准TxPDO布局（0x1A00）
+
+    /**
+     * @brief 标准PDO映射，configurePdo()与PDO配置数组均由此生成
+     */
+    typedef Cia402Mapping Mapping;
+
+    /**
+     * @brief 按标准布局解码电机状态
+     * @param domain_pd 域过程数据指针
+     * @param tx_offsets TxLayout对应的偏移量数组
+     * @return 电机状态
+     *
+     * 非虚函数，编译后为若干次直接读取
+     */
+    static MotorStatus decodeStatus(const uint8_t* domain_pd, const unsigned int* tx_offsets) {
+        MotorStatus status;
+        status.status_word = TxLayout::get<0x6041>(domain_pd, tx_offsets);
+        status.actual_position = TxLayout::get<0x6064>(domain_pd, tx_offsets);
+        status.actual_velocity = TxLayout::get<0x606C>(domain_pd, tx_offsets);
+        status.actual_torque = TxLayout::get<0x6077>(domain_pd, tx_offsets);
+        status.operation_mode = TxLayout::get<0x6061>(domain_pd, tx_offsets);
+        status.error_code = TxLayout::get<0x603F>(domain_pd, tx_offsets);
+        return status;
+    }
+
+    /**
+     * @brief 按标准布局写入控制数据
+     * @param domain_pd 域过程数据指针
+     * @param rx_offsets RxLayout对应的偏移量数组
+     * @param control 控制数据
+     *
+     * 非虚函数，编译后为若干次直接写入
+     */
+    static void encodeControl(uint8_t* domain_pd, const unsigned int* rx_offsets, const MotorControl& control) {
+        RxLayout::set<0x6040>(domain_pd, rx_offsets, control.control_word);
+        RxLayout::set<0x607A>(domain_pd, rx_offsets, control.target_position);
+        RxLayout::set<0x60FF>(domain_pd, rx_offsets, control.target_velocity);
+        RxLayout::set<0x6071>(domain_pd, rx_offsets, control.target_torque);
+        RxLayout::set<0x6060>(domain_pd, rx_offsets, control.operation_mode);
+    }
+
     MotorInfo getMotorInfo() const override;
     bool configurePdo(ec_slave_config_t* slave_config) override;
     std::vector<PdoConfig> getRxPdoConfig() const override;
@@ -199,6 +290,20 @@ public:
     bool supportsMotor(uint32_t vendor_id, uint32_t product_code) const override;
     std::string getName() const override;
     uint16_t makeControl(uint16_t status, int32_t &start_pos, bool &run_enable) const override;
+    const Cia402Table& stateTable() const override;
+
+    /**
+     * @brief 按标准布局批量解码/编码与查表
+     *
+     * 循环体只包含decodeStatus()/encodeControl()/lookup()的内联展开。
+     * 重写了readStatus()/writeControl()/makeControl()的派生类需同时重写对应的批处理函数
+     */
+    void decodeBatch(const uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                     size_t count, MotorStatus* out) const override;
+    void encodeBatch(uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                     size_t count, const MotorControl* in) const override;
+    void makeControlBatch(const uint16_t* status, size_t count,
+                          uint16_t* control, bool* run_enable) const override;
 
 protected:
     /**
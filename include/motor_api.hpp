@@ -15,7 +15,26 @@
 #include <stddef.h>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <utility>
 #include "motor_adapter.hpp"
+#include "axis_data.hpp"
+#include "pdo_handle.hpp"
+#include "cia402_state_machine.hpp"
+#include "status_masks.hpp"
+#include "cyclic_runner.hpp"
+#include "cycle_stats.hpp"
+#include "cycle_watchdog.hpp"
+#include "task_scheduler.hpp"
+#include "cycle_hooks.hpp"
+#include "cycle_fds.hpp"
+#include "axis_worker_pool.hpp"
+#include "setpoint_stream.hpp"
+#include "axis_mailbox.hpp"
+#include "axis_ops.hpp"
+#include "axis_events.hpp"
+#include <pthread.h>
+#include <atomic>
 
 /**
  * @class MotorApi
@@ -66,15 +85,473 @@ public:
    */
   void receive_and_process();
   
+  /**
+   * @brief 启用或禁用周期输入快照
+   * @param enabled true 启用，false 禁用
+   * 
+   * 启用后receive_and_process()会在一次扫描中解码所有轴的TxPDO字段
+   * 到snapshot()，各个get_*函数直接读取快照而不再访问域数据。
+   */
+  void set_snapshot_enabled(bool enabled);
+  
+  /**
+   * @brief 检查周期输入快照是否启用
+   * @return true 已启用，false 未启用
+   */
+  bool snapshot_enabled() const;
+  
+  /**
+   * @brief 获取周期输入快照
+   * @return 最近一次receive_and_process()解码的全轴快照
+   * 
+   * 状态字字段每周期更新（用于计算状态掩码），其余字段仅在
+   * set_snapshot_enabled(true)后每周期更新
+   */
+  const AxisSnapshot& snapshot() const;
+  
+  /**
+   * @brief 获取全轴状态掩码
+   * @return 最近一次receive_and_process()计算的掩码，第m位对应电机m；
+   *         线程模式下在应用线程中调用时由最近一次完整发布的状态字计算
+   * 
+   * 仅前kMaxMaskAxes个电机参与统计
+   */
+  StatusMasks status_masks() const;
+
+  /**
+   * @brief 启用轴状态变化事件流
+   * @param capacity 事件队列容量，向上取整为2的幂
+   * @param status_mask 状态字比较屏蔽字，默认任一位变化都产生事件；
+   *        驱动器在某些模式下翻转的位（如0x1000设定值确认）可在此屏蔽
+   * @return true 成功，false 尚未初始化或容量为0
+   *
+   * 在周期循环开始之前调用。启用后receive_and_process()在计算状态掩码之后比较各轴的
+   * 状态字、操作模式显示和错误代码，变化时写入一条带接收序号和时间戳的事件，
+   * 启用后的第一次接收只记录基准值。消费者在任意线程读取，代替每周期轮询get_status()：
+   * @code
+   * AxisEventCursor cursor = api.events().cursor();
+   * AxisEvent buf[64];
+   * size_t n = api.events().read(cursor, buf, 64);
+   * for (size_t i = 0; i < n; ++i) {
+   *   if (buf[i].field == AxisEventField::StatusWord && buf[i].entered(0x08, 0x08)) { ... }  // 进入故障
+   * }
+   * @endcode
+   */
+  bool enable_events(size_t capacity = 4096, uint16_t status_mask = 0xFFFF);
+
+  /**
+   * @brief 获取轴状态变化事件流
+   */
+  const AxisEventStream& events() const;
+
+  /**
+   * @brief 获取操作使能轴掩码
+   * @return 状态为0x27的电机位掩码
+   */
+  uint64_t enabled_mask() const;
+  
+  /**
+   * @brief 获取故障轴掩码
+   * @return 故障位置位的电机位掩码
+   */
+  uint64_t fault_mask() const;
+  
+  /**
+   * @brief 检查是否所有电机均已操作使能
+   * @return true 全部使能，false 存在未使能电机或没有电机
+   */
+  bool all_enabled() const;
+  
+  /**
+   * @brief 检查是否有电机处于故障
+   * @return true 存在故障电机，false 无故障
+   */
+  bool any_fault() const;
+  
   /**
    * @brief 排队并发送EtherCAT数据
    * 将待发送数据排队并通过EtherCAT总线发送
    */
   void queue_and_send();
   
+  /**
+   * @brief 获取周期耗时统计
+   * @return 各阶段的耗时直方图（纳秒）
+   * 
+   * receive_and_process()与queue_and_send()始终记录接收、计算、发送耗时和
+   * 周期间隔，run_cyclic()额外记录唤醒延迟。直方图无锁，可在其他线程读取。
+   */
+  const CycleStats& cycle_stats() const;
+  
+  /**
+   * @brief 清空周期耗时统计
+   */
+  void reset_cycle_stats();
+  
+  /**
+   * @brief 周期回调类型
+   * 
+   * 在receive_and_process()之后、queue_and_send()之前调用，返回false结束循环
+   */
+  typedef std::function<bool(MotorApi&)> CycleCallback;
+  
+  /**
+   * @brief 以实时周期运行控制循环
+   * @param config 实时配置（周期、SCHED_FIFO优先级、CPU亲和性、mlockall、栈预触碰）
+   * @param callback 周期回调
+   * @return true 循环正常结束，false 尚未初始化
+   * 
+   * 在调用线程上应用实时配置，按绝对截止时间以clock_nanosleep(TIMER_ABSTIME)
+   * 推进周期，每周期依次执行receive_and_process()、callback、queue_and_send()，
+   * 已注册的钩子在各阶段前后执行（见hooks()）。
+   * 回调返回false或running()变为false时返回。实时配置应用失败只打印警告。
+   * 
+   * 亚毫秒周期（250-500µs）建议设置spin_margin_ns（如50000）以自旋消除唤醒抖动，
+   * 并设置send_offset_ns使发送时刻固定；实际发送时刻的偏差记入cycle_stats().send_jitter。
+   * 
+   * 上一周期的工作越过截止时间时，本周期按overrun_policy降级（跳过回调并重发、
+   * 保持位置或外推目标），避免驱动器看到目标位置阶跃而报跟随误差；
+   * 连续超时达到overrun_stop_after次时全部电机快速停止（0x0002）并返回。
+   * 
+   * pipelined为true时每周期依次执行receive_and_process()、发送上一周期回调写出的设定值、
+   * callback：回调读到的是本周期的输入，写出的设定值在下一周期发出。帧发出时刻只取决于
+   * 接收耗时，不受回调耗时抖动影响，适合DC同步的CSP；代价是一个周期的额外延迟。
+   * 超时周期照常发出已暂存的设定值，由降级策略代替回调生成下一帧；快速停止不经流水线，
+   * 在本周期直接发出。
+   */
+  bool run_cyclic(const RtConfig& config, const CycleCallback& callback);
+  
+  /**
+   * @brief 以指定周期运行控制循环，不修改调度参数
+   * @param period_us 周期（微秒）
+   * @param callback 周期回调
+   * @return true 循环正常结束，false 尚未初始化
+   */
+  bool run_cyclic(uint32_t period_us, const CycleCallback& callback);
+  
+  /**
+   * @brief 启动线程模式：由内部实时线程持有总线
+   * @param config 实时配置，在内部线程上应用（优先级、CPU绑定等）
+   * @param callback 周期回调，在内部线程上执行，可为空
+   * @return true 启动成功，false 尚未初始化、已在运行或线程创建失败
+   * 
+   * 内部线程执行run_cyclic()，每周期在接收之后把各轴输入发布到双缓冲反馈区，
+   * 在回调之前取走应用线程写入的命令。启动后可在任意线程调用get_status()、
+   * get_actual_pos()等读取函数和write_control()、update_target_pos()、set_opmode()、
+   * reset()、quick_stop_all()等写入函数：读取得到最近一次完整发布的输入，
+   * 写入在下一周期发出，同一周期内对同一轴的多次写入只有最后一次生效。
+   * 这些调用不加锁，内部线程不会因应用线程而等待。
+   * 
+   * 回调、钩子和parallel_for_axes()的区间任务在总线线程上执行，照常直接访问域数据。
+   * receive_and_process()、queue_and_send()在应用线程中调用时直接返回；
+   * status_masks()、enabled_mask()等掩码函数与get_drive_state()在应用线程中取自最近一次发布，
+   * overrun_count()、overrun_tripped()、watchdog_tripped()为原子量，同样可在任意线程调用；
+   * make_control()、批量适配器接口与snapshot()不经交换区，应只在总线线程中使用。
+   * 可用poll_snapshot()或周期完成通知（open_cycle_event()）得知新一周期的输入。
+   * 内部循环因看门狗或连续超时结束后仍保持线程模式（读取得到最后一次发布的输入），
+   * 应检查watchdog_tripped()、overrun_tripped()并调用stop_threaded()。
+   */
+  bool start_threaded(const RtConfig& config, const CycleCallback& callback = CycleCallback());
+  
+  /**
+   * @brief 停止线程模式并等待内部线程退出
+   * 
+   * 返回后读写函数恢复为直接访问域数据
+   */
+  void stop_threaded();
+  
+  /**
+   * @brief 检查是否处于线程模式
+   */
+  bool threaded() const;
+  
+  /**
+   * @brief 异步使能全部电机
+   * @param timeout_ms 超时（毫秒）
+   * @return 完成令牌，全部电机进入操作使能（0x27）时以Done完成
+   * 
+   * 周期循环每周期为尚未使能的电机推进状态机、写出控制字，并令目标位置跟随实际位置，
+   * 代替在回调中手写的make_control()轮询。可在任意线程调用，例如：
+   * @code
+   * AxisOp op = api.enable_all();
+   * // 周期循环在run_cyclic()或线程模式中运行
+   * if (op.wait() != OpStatus::Done) { ... }
+   * @endcode
+   * 操作在run_cyclic()、dispatch_timer()或poll_operations()中推进，先于设定值流与周期回调；
+   * 回调不应再为操作涉及的电机写控制字或目标位置。
+   * 
+   * 操作用自己的一组状态机（绑定各轴的转换表）生成控制字，不推进make_control()使用的轴状态机，
+   * 因此回调照常每周期调用make_control()时去抖与故障复位计数不会被推进两次。
+   * 但回调随后写出的控制字会覆盖操作本周期写出的控制字，这种情况下操作只负责等待0x27完成；
+   * get_drive_state()反映的是轴状态机，只在回调调用make_control()时更新。
+   */
+  AxisOp enable_all(uint32_t timeout_ms = 5000);
+  
+  /**
+   * @brief 异步定位
+   * @param motor 电机索引
+   * @param position 终点
+   * @param options 每周期最大步长、到位窗口与超时
+   * @return 完成令牌，目标位置到达终点且实际位置进入到位窗口时以Done完成
+   * 
+   * 电机须已处于操作使能，未使能或定位中出现故障时以Failed完成。
+   * 同一电机上新的定位取代未完成的旧定位（旧令牌以Cancelled完成）。
+   */
+  AxisOp move_to(size_t motor, int32_t position, const MoveOptions& options = MoveOptions());
+  
+  /**
+   * @brief 异步故障复位
+   * @param mask 电机掩码，第m位对应第m个电机（最多64个）
+   * @param timeout_ms 超时（毫秒）
+   * @return 完成令牌，掩码内全部电机的故障位清除时以Done完成
+   * 
+   * 对处于故障的电机先写0再保持0x0080以产生复位上升沿，故障清除后控制字写回0
+   */
+  AxisOp reset_faults(uint64_t mask, uint32_t timeout_ms = 1000);
+  
+  /**
+   * @brief 推进未完成的异步操作
+   * 
+   * run_cyclic()与dispatch_timer()每周期自动调用；自行编写循环时在receive_and_process()
+   * 之后、回调逻辑之前调用。没有未完成操作时只有一次判断。
+   */
+  void poll_operations();
+  
+  /**
+   * @brief 启动轴计算工作线程
+   * @param config 线程池配置（线程数、各线程绑定的CPU、优先级）
+   * @return true 启动成功，false 已在运行或线程创建失败
+   */
+  bool start_workers(const WorkerPoolConfig& config);
+  
+  /**
+   * @brief 停止轴计算工作线程
+   */
+  void stop_workers();
+  
+  /**
+   * @brief 将全部电机按连续区间分给主线程和工作线程并行处理
+   * @param fn 区间任务，处理[begin, end)内的电机
+   * 
+   * 在周期回调中调用，返回时所有区间已完成，随后由主线程统一queue_and_send()。
+   * 区间任务中对本区间电机调用get_status、get_actual_pos等读取函数以及make_control、
+   * write_control、update_target_pos、set_opmode是安全的（各轴只访问自己的控制块和PDO），
+   * 不应调用涉及全轴状态的函数。未启动工作线程时在当前线程串行执行。
+   */
+  void parallel_for_axes(const AxisWorkerPool::RangeFn& fn);
+  
+  /**
+   * @brief 获取多速率任务调度器
+   * @return 调度器，在run_cyclic()之前注册任务
+   * 
+   * run_cyclic()在每周期queue_and_send()之后执行到期任务，诊断、状态检查等
+   * 慢任务不推迟帧的发出；超时降级的周期不执行任务。
+   * 周期号从1开始，分频数可用TaskScheduler::divisor_for()由时间间隔换算。
+   */
+  TaskScheduler& scheduler();
+  
+  /**
+   * @brief 获取周期钩子流水线
+   * @return 钩子流水线，在run_cyclic()之前注册钩子
+   * 
+   * run_cyclic()每周期依次执行：PreReceive钩子、receive_and_process()、PostProcess钩子、
+   * 周期回调、PreSend钩子、queue_and_send()。任一钩子返回false时与回调返回false相同，
+   * 结束循环。超时降级的周期跳过PostProcess钩子与回调，降级输出仍经过PreSend钩子；
+   * 流水线模式下PostProcess钩子、回调与PreSend钩子在发送之后为下一帧执行。
+   * 各钩子的耗时分布见CycleHooks::timing()，run_cyclic()结束时打印摘要。
+   */
+  CycleHooks& hooks();
+  
+  /**
+   * @brief 为电机启用设定值流
+   * @param motor 电机索引
+   * @param config 队列容量与欠载策略
+   * @return true 成功，false 电机索引无效
+   * 
+   * 在run_cyclic()之前调用，已启用时以新配置重建（丢弃未消费的设定值）。
+   * 启用后每周期在PostProcess钩子和回调之前从队列取出一个设定值写入目标位置，
+   * 回调仍可覆盖；超时降级的周期在降级输出之后照常取数，流式轴的目标位置保持连续。
+   * 收到第一个设定值之前不写目标位置，之后队列为空时按策略保持或外推。
+   */
+  bool enable_setpoint_stream(size_t motor, const SetpointStreamConfig& config = SetpointStreamConfig());
+  
+  /**
+   * @brief 停用电机的设定值流
+   * @param motor 电机索引
+   * 
+   * 不得在周期循环运行时调用
+   */
+  void disable_setpoint_stream(size_t motor);
+  
+  /**
+   * @brief 获取电机的设定值流
+   * @param motor 电机索引
+   * @return 设定值流，未启用时为nullptr
+   * 
+   * 规划线程通过push()写入设定值（每个流只允许一个生产者线程），
+   * 任意线程可通过fill()、stats()查看水位与欠载情况
+   */
+  SetpointStream* setpoint_stream(size_t motor);
+  
+  /**
+   * @brief 创建周期定时器描述符（timerfd）
+   * @param period_us 周期（微秒）
+   * @return true 成功，false 已创建或创建失败
+   * 
+   * 用于在外部epoll/poll事件循环中驱动总线周期，代替run_cyclic()和usleep：
+   * @code
+   * api.open_cycle_timer(1000);
+   * // 将api.cycle_timer_fd()以EPOLLIN加入epoll
+   * // 可读时：if (!api.dispatch_timer(callback)) 退出循环;
+   * @endcode
+   */
+  bool open_cycle_timer(uint32_t period_us);
+  
+  /**
+   * @brief 获取周期定时器描述符，未创建时为-1
+   */
+  int cycle_timer_fd() const;
+  
+  /**
+   * @brief 周期定时器可读时执行一个总线周期
+   * @param callback 周期回调
+   * @return true 继续，false 回调或钩子结束循环、看门狗已触发或尚未初始化
+   * 
+   * 非阻塞读取定时器到期次数，尚未到期时直接返回true。一个周期的步骤与run_cyclic()相同：
+   * PreReceive钩子、receive_and_process()、PostProcess钩子、回调、PreSend钩子、
+   * queue_and_send()、到期的多速率任务。定时器截止时间到实际处理的延迟记入
+   * cycle_stats().wakeup；事件循环错过的周期直接跳过并计入overrun_count()。
+   * 不应用RtConfig，也不执行超时降级与流水线模式。
+   */
+  bool dispatch_timer(const CycleCallback& callback);
+  
+  /**
+   * @brief 创建周期完成通知描述符（eventfd）
+   * @return true 成功，false 已创建或创建失败
+   * 
+   * 创建后每次queue_and_send()完成时计数加1（一次write系统调用），
+   * 无论周期由run_cyclic()、dispatch_timer()还是自行编写的循环驱动。
+   * 描述符可读表示有新周期完成，读取后用drain_cycle_event()清零。
+   */
+  bool open_cycle_event();
+  
+  /**
+   * @brief 获取周期完成通知描述符，未创建时为-1
+   */
+  int cycle_event_fd() const;
+  
+  /**
+   * @brief 非阻塞读取并清零周期完成通知
+   * @return 自上次读取以来完成的周期数，没有新周期时为0
+   */
+  uint64_t drain_cycle_event();
+  
+  /**
+   * @brief 关闭周期定时器与完成通知描述符
+   * 
+   * 不应在周期运行时调用
+   */
+  void close_event_fds();
+  
+  /**
+   * @brief 获取输入快照序号
+   * @return 已完成的receive_and_process()次数
+   */
+  uint64_t snapshot_seq() const;
+  
+  /**
+   * @brief 非阻塞检查是否有新的输入
+   * @param seq 调用方上次看到的快照序号，有新输入时更新为当前序号
+   * @return true 自seq以来有新的输入，false 没有
+   * 
+   * 不阻塞也不加锁。有新输入时通过get_status()、snapshot()等读取；
+   * 这些读取与驱动周期的代码不同步，应在同一线程调用（如同一事件循环中）。
+   */
+  bool poll_snapshot(uint64_t& seq) const;
+  
+  /**
+   * @brief 获取最近一次run_cyclic()中的超时周期数
+   * @return 超时次数
+   */
+  uint64_t overrun_count() const;
+  
+  /**
+   * @brief 检查最近一次run_cyclic()是否因连续超时而快速停止
+   * @return true 已触发受控停机
+   */
+  bool overrun_tripped() const;
+  
+  /**
+   * @brief 全部电机保持当前位置并发出快速停止命令
+   * 
+   * 目标位置写为实际位置，控制字写0x0002，需随后queue_and_send()
+   */
+  void quick_stop_all();
+  
+  /**
+   * @brief 启动带外看门狗
+   * @param config 看门狗配置（检查周期、停滞时限、优先级应低于周期线程）
+   * @return true 启动成功，false 尚未初始化、已在运行或线程创建失败
+   * 
+   * queue_and_send()每周期发布心跳。心跳停滞超过时限时看门狗打印诊断信息并置位
+   * watchdog_tripped()；若周期线程停在总线收发区之外，看门狗直接接管总线发送
+   * 快速停止帧（停滞期间每个检查周期一次），否则在周期线程恢复后由其执行快速停止。
+   * run_cyclic()检测到触发后发送快速停止帧并返回；自行编写循环时应检查watchdog_tripped()。
+   * 
+   * 看门狗只在布防期间检查心跳：run_cyclic()（包括线程模式）开始时布防、返回前撤防，
+   * 初始化、复位等待等循环之外的停顿不会触发。使用dispatch_timer()或自行编写循环时，
+   * 在进入循环前调用arm_watchdog()，退出后调用disarm_watchdog()。
+   * 触发状态一直保持，run_cyclic()拒绝启动，确认安全后调用rearm_watchdog()清除。
+   */
+  bool start_watchdog(const WatchdogConfig& config);
+  
+  /**
+   * @brief 停止看门狗
+   */
+  void stop_watchdog();
+  
+  /**
+   * @brief 布防看门狗（dispatch_timer()或自行编写的循环开始时调用）
+   */
+  void arm_watchdog();
+  
+  /**
+   * @brief 撤防看门狗（dispatch_timer()或自行编写的循环结束后调用）
+   */
+  void disarm_watchdog();
+  
+  /**
+   * @brief 清除看门狗触发状态
+   * @return true 已清除，false 周期循环仍处于停滞
+   * 
+   * 触发后watchdog_tripped()保持为true、run_cyclic()拒绝启动，直到调用本函数
+   */
+  bool rearm_watchdog();
+  
+  /**
+   * @brief 获取看门狗（心跳、停滞次数与停滞时长统计）
+   */
+  const CycleWatchdog& watchdog() const;
+  
+  /**
+   * @brief 检查看门狗是否已触发
+   * @return true 检测到周期停滞并进入快速停止
+   */
+  bool watchdog_tripped() const;
+  
+  /**
+   * @brief 打印诊断信息
+   * 
+   * 输出周期耗时统计、状态掩码与各轴最近的状态字、控制字和目标位置。
+   * 读取周期线程的非原子状态，须在周期线程中（如周期回调）或周期循环停止后调用
+   */
+  void dump_diagnostics() const;
+  
   /**
    * @brief 清理EtherCAT资源
    * 释放EtherCAT主站、域等资源，安全退出
+   * 
+   * 会停止并等待内部线程，只能在持有对象的应用线程中调用，不能在信号处理函数或库内部线程中调用
    */
   void cleanup();
   
@@ -82,7 +559,8 @@ public:
    * @brief 信号处理函数
    * @param signum 信号编号
    * 
-   * 处理SIGINT等信号，触发清理操作
+   * 处理SIGINT信号，只清除运行标志使run_cyclic()返回；信号处理函数中不释放资源，
+   * 应用在循环返回后调用cleanup()
    */
   static void signal_handler(int);
   
@@ -121,9 +599,18 @@ public:
    * @param run_enable 运行使能标志引用
    * @return 生成的控制字
    * 
-   * 根据当前状态生成适当的控制字，管理状态机转换
+   * 推进该轴的CiA 402状态机并返回本周期的控制字。每个轴持有独立的
+   * 状态机，转换表由适配器的stateTable()提供；仅在操作使能状态下置位run_enable
    */
   uint16_t make_control(size_t motor, uint16_t status, int32_t &start_pos, bool &run_enable);
+
+  /**
+   * @brief 获取轴的CiA 402状态
+   * @param motor 电机索引
+   * @return 最近一次make_control()识别的状态，索引无效时返回Unknown；
+   *         线程模式下在应用线程中调用时为随最近一次反馈发布的状态（比总线线程晚一个周期）
+   */
+  Cia402State get_drive_state(size_t motor) const;
   
   /**
    * @brief 写入控制字
@@ -146,6 +633,92 @@ public:
    */
   int32_t get_actual_pos(size_t motor) const;
   
+  /**
+   * @brief 获取实际速度
+   * @param motor 电机索引
+   * @return 实际速度值
+   */
+  int32_t get_actual_velocity(size_t motor) const;
+  
+  /**
+   * @brief 获取实际力矩
+   * @param motor 电机索引
+   * @return 实际力矩值
+   */
+  int16_t get_actual_torque(size_t motor) const;
+  
+  /**
+   * @brief 获取操作模式显示
+   * @param motor 电机索引
+   * @return 当前操作模式
+   */
+  int8_t get_mode_display(size_t motor) const;
+  
+  /**
+   * @brief 获取错误代码
+   * @param motor 电机索引
+   * @return 错误代码
+   */
+  uint16_t get_error_code(size_t motor) const;
+  
+  /**
+   * @brief 批量读取全部电机的状态字
+   * @param status 输出数组，长度不小于motor_count()
+   * 
+   * 在一次循环中按预先解析的偏移量读取所有电机，快照启用时直接复制快照
+   */
+  void read_status_all(uint16_t *status) const;
+  
+  /**
+   * @brief 批量读取全部电机的实际位置
+   * @param positions 输出数组，长度不小于motor_count()
+   */
+  void read_positions_all(int32_t *positions) const;
+  
+  /**
+   * @brief 批量写入全部电机的目标位置
+   * @param targets 目标位置数组，长度不小于motor_count()
+   */
+  void write_targets_all(const int32_t *targets);
+  
+  /**
+   * @brief 批量写入全部电机的控制字
+   * @param controls 控制字数组，长度不小于motor_count()
+   */
+  void write_controls_all(const uint16_t *controls);
+  
+  /**
+   * @brief 批量推进全部电机的状态机
+   * @param status 状态字数组，长度不小于motor_count()
+   * @param controls 输出控制字数组，长度不小于motor_count()
+   * @param run_enable 输出运行使能标志数组，长度不小于motor_count()
+   * 
+   * 与逐轴调用make_control()等价
+   */
+  void make_controls_all(const uint16_t *status, uint16_t *controls, bool *run_enable);
+  
+  /**
+   * @brief 按适配器分组批量读取电机状态
+   * @param out 输出数组，长度不小于motor_count()
+   * 
+   * 每个适配器分组只有一次decodeBatch()虚调用
+   */
+  void read_motor_status_all(MotorAdapter::MotorStatus *out);
+  
+  /**
+   * @brief 按适配器分组批量写入控制数据
+   * @param in 控制数据数组，长度不小于motor_count()
+   * 
+   * 每个适配器分组只有一次encodeBatch()虚调用
+   */
+  void write_motor_control_all(const MotorAdapter::MotorControl *in);
+  
+  /**
+   * @brief 获取适配器分组数量
+   * @return 分组数量，通常等于现场的厂家数量
+   */
+  size_t adapter_group_count() const;
+  
  /**
    * @brief 复位电机
    * @param motor 电机索引
@@ -172,7 +745,173 @@ public:
    * 获取指定电机的厂商信息，用于调试和日志记录
    */
   std::string get_motor_info(size_t motor) const;
+
+  /**
+   * @brief 解析任意已映射对象的类型化句柄
+   * @tparam T 条目数据类型，位长度须与适配器映射一致
+   * @param motor 电机索引
+   * @param index 对象索引（如0x606C实际速度），须在适配器的PDO映射中
+   * @param subindex 子索引
+   * @return 条目句柄，对象未映射或类型位宽不匹配时返回无效句柄
+   * 
+   * 须在初始化完成后、进入周期循环前调用；周期内使用句柄的
+   * read()/write()配合domain_data()进行O(1)访问。
+   */
+  template <typename T>
+  PdoHandle<T> map_entry(size_t motor, uint16_t index, uint8_t subindex = 0x00) const;
+
+  /**
+   * @brief 获取域过程数据指针
+   * @return 域数据指针，初始化前为nullptr
+   */
+  uint8_t *domain_data() const;
 private:
+  /**
+   * @brief 查找指定对象在域内的偏移量
+   * @param motor 电机索引
+   * @param index 对象索引
+   * @param subindex 子索引
+   * @param offset 输出偏移量
+   * @param bit_length 输出位长度，可为nullptr
+   * @return true 找到，false 适配器未映射该对象
+   *
+   * 仅在初始化阶段使用，会构造适配器的PDO配置数组并线性查找。
+   */
+  bool find_pdo_offset(size_t motor, uint16_t index, uint8_t subindex, unsigned int &offset,
+                       uint8_t *bit_length = nullptr) const;
+
+  /**
+   * @brief 分配控制块并构建PDO槽位表
+   *
+   * PDO注册完成且域数据有效后调用，为每个电机解析常用对象的偏移量。
+   */
+  void build_pdo_slots();
+
+  /**
+   * @brief 绑定各轴适配器与状态机
+   *
+   * 在控制块中记录适配器指针，并将状态机绑定到适配器的转换表
+   */
+  void build_state_machines();
+
+  /**
+   * @brief 按适配器对电机分组
+   * 
+   * 共享同一适配器实例的电机归为一组，并预分配组内的批处理缓冲区
+   */
+  void build_adapter_groups();
+  
+  /**
+   * @brief 解码全轴输入快照
+   * 
+   * 按字段顺序扫描槽位表，将所有轴的TxPDO数据写入snapshot_
+   */
+  void decode_snapshot();
+  
+  /**
+   * @brief 采集全轴状态字
+   * 
+   * 快照未启用时只解码状态字字段，供计算状态掩码使用
+   */
+  void gather_status_words();
+  
+  /**
+   * @brief 在超时周期内按降级策略写入输出
+   * @param policy 降级策略
+   * @return true 已写入输出、应跳过用户回调，false 照常执行回调
+   */
+  bool apply_overrun_policy(OverrunPolicy policy);
+  
+  /**
+   * @brief 在配置的发送偏移处提交并发送，记录发送抖动
+   * @param runner 周期调度器
+   */
+  void send_at_offset(CyclicRunner& runner);
+  
+  /**
+   * @brief 当前线程是否应经交换区访问（线程模式下的非总线线程）
+   */
+  bool via_mailbox() const;
+  
+  /**
+   * @brief 将各轴输入发布到反馈区（总线线程，接收之后）
+   */
+  void publish_feedback();
+  
+  /**
+   * @brief 取走应用线程写入的命令并写入域数据（总线线程，回调之前）
+   */
+  void apply_commands();
+  
+  /**
+   * @brief 线程模式的内部线程入口
+   */
+  static void* threaded_entry(void* arg);
+  
+  /**
+   * @brief 从各轴设定值流取出本周期的目标位置并写入
+   */
+  void consume_setpoints();
+  
+  /**
+   * @brief 由各轴的输出槽位合并出域内输出区间，并以当前域数据初始化暂存区
+   */
+  void build_output_spans();
+  
+  /**
+   * @brief 将域内输出区间复制到暂存区（流水线模式，回调之后）
+   */
+  void stage_outputs();
+  
+  /**
+   * @brief 将暂存区写回域内输出区间（流水线模式，接收之后）
+   * 
+   * 接收时主站把回传帧拷回域内存，输出区被还原为上一帧发出的值，
+   * 回调在发送之后写入的设定值因此需要暂存并在发送前写回
+   */
+  void restore_outputs();
+  
+  /**
+   * @brief 占用总线收发区
+   * @return true 已占用，false 看门狗正在发送
+   */
+  bool claim_bus();
+  
+  /**
+   * @brief 由交换区最近一次发布的状态字计算全轴状态掩码（线程模式下的应用线程）
+   */
+  StatusMasks published_masks() const;
+  
+  /**
+   * @brief 释放总线收发区（未持有时不做任何事）
+   */
+  void release_bus();
+  
+  /**
+   * @brief 打印心跳与周期耗时直方图（只读原子计数，看门狗线程可调用）
+   */
+  void dump_cycle_timing() const;
+  
+  /**
+   * @brief 看门狗停滞处理（在看门狗线程中调用）
+   * @param stall_ns 当前停滞时长
+   * @param first 是否为本次停滞的首次调用
+   */
+  void on_watchdog_stall(uint64_t stall_ns, bool first);
+
+  /**
+   * @brief 适配器分组
+   * 
+   * 组内电机的偏移量与批处理缓冲区连续存放，批处理内核按组调用
+   */
+  struct AdapterGroup {
+    MotorAdapter *adapter;                                  ///< 组内共享的适配器
+    std::vector<size_t> axes;                               ///< 组内电机索引
+    std::vector<const std::vector<unsigned int>*> offsets;  ///< 组内电机的PDO偏移量数组
+    std::vector<MotorAdapter::MotorStatus> status;          ///< 状态缓冲区
+    std::vector<MotorAdapter::MotorControl> control;        ///< 控制缓冲区
+  };
+
   ec_master_t *master_;                    ///< EtherCAT主站句柄
   ec_domain_t *domain_;                      ///< EtherCAT域句柄
   std::vector<ec_slave_config_t*> scs_;      ///< 从站配置数组
@@ -186,8 +925,62 @@ private:
   // PDO条目偏移量数组，每个电机对应一组偏移量
   std::vector<std::vector<unsigned int>> pdo_offsets_;  ///< 每个电机的PDO偏移量数组
   
+  // 周期控制块（热数据），每个电机一个缓存行对齐的块；
+  // 上面的适配器所有权、偏移量数组、从站配置等只在初始化和诊断时访问（冷数据）
+  AlignedArray<AxisBlock> axes_;                     ///< 周期访问使用的控制块
+  
+  AxisSnapshot snapshot_;                            ///< 全轴输入快照
+  bool snapshot_enabled_;                            ///< 是否每周期解码快照
+  StatusMasks status_masks_;                         ///< 全轴状态掩码
+  
+  CycleStats cycle_stats_;                           ///< 周期耗时统计
+  uint64_t last_rx_start_ns_;                        ///< 上一次接收开始时间，0表示尚无
+  uint64_t rx_end_ns_;                               ///< 本周期接收结束时间，0表示尚未接收
+  std::atomic<uint64_t> overruns_;                   ///< run_cyclic()中的超时周期数（线程模式下应用线程读取）
+  std::atomic<bool> overrun_tripped_;                ///< 是否因连续超时而快速停止（线程模式下应用线程读取）
+  
+  // 总线收发区（receive_and_process()到queue_and_send()）的占用者：0空闲，1周期线程，2看门狗
+  enum { kBusFree = 0, kBusCyclic = 1, kBusWatchdog = 2 };
+  std::atomic<int> bus_owner_;                       ///< 总线收发区占用者
+  bool bus_held_;                                    ///< 周期线程是否持有总线收发区
+  std::atomic<bool> watchdog_tripped_;               ///< 看门狗是否已触发
+  CycleWatchdog watchdog_;                           ///< 带外看门狗
+  TaskScheduler scheduler_;                          ///< 多速率任务调度器
+  CycleHooks hooks_;                                 ///< 周期钩子流水线
+  CycleTimerFd cycle_timer_;                         ///< 外部事件循环使用的周期定时器
+  CycleEventFd cycle_event_;                         ///< 周期完成通知
+  std::atomic<uint64_t> snapshot_seq_;               ///< 已完成的接收次数
+  AxisWorkerPool workers_;                           ///< 轴计算工作线程池
+  std::vector<std::pair<unsigned int, unsigned int>> output_spans_;  ///< 域内输出区间[begin, end)
+  std::vector<uint8_t> staged_outputs_;              ///< 流水线模式暂存的下一帧输出，按域内偏移存放
+  std::vector<std::unique_ptr<SetpointStream>> streams_;  ///< 各轴设定值流，未启用为空
+  size_t stream_count_;                              ///< 已启用设定值流的轴数
+  AxisMailbox mailbox_;                              ///< 线程模式的轴数据交换区
+  AxisOpQueue ops_;                                  ///< 异步操作队列
+  AxisEventStream events_;                           ///< 轴状态变化事件流
+  std::atomic<bool> threaded_;                       ///< 是否处于线程模式
+  std::atomic<bool> thread_stop_;                    ///< 请求内部线程退出
+  pthread_t bus_thread_;                             ///< 线程模式的内部线程
+  RtConfig thread_config_;                           ///< 内部线程的实时配置
+  CycleCallback thread_callback_;                    ///< 内部线程的周期回调
+  
+  std::vector<AdapterGroup> groups_;                ///< 按适配器划分的电机分组
+  
   std::vector<ec_pdo_entry_reg_t> regs_;            ///< PDO条目注册数组
-  bool run_;                                        ///< 运行状态标志
+  std::atomic<bool> run_;                           ///< 运行状态标志（信号处理函数中清除）
 };
 
-#endif
\ No newline at end of file
+template <typename T>
+PdoHandle<T> MotorApi::map_entry(size_t motor, uint16_t index, uint8_t subindex) const {
+  unsigned int offset = 0;
+  uint8_t bit_length = 0;
+  if (!domain_pd_ || !find_pdo_offset(motor, index, subindex, offset, &bit_length)) {
+    return PdoHandle<T>();
+  }
+  if (bit_length != sizeof(T) * 8) {
+    return PdoHandle<T>();
+  }
+  return PdoHandle<T>(offset);
+}
+
+#endif
@@ -0,0 +1,386 @@
+#ifndef MOTOR_API_STATIC_HPP
+#define MOTOR_API_STATIC_HPP
+
+/**
+ * @file motor_api_static.hpp
+ * @brief 定容量电机控制API
+ *
+ * MotorApiStatic<MaxAxes>与MotorApi提供相同的周期接口，但从站配置、PDO偏移、
+ * 注册表和状态机全部保存在对象内的定长数组中，不使用std::vector、std::string、
+ * std::shared_ptr，也不在任何阶段分配堆内存，内存占用在编译期确定。
+ *
+ * 适配器以编译期PDO映射（Mapping模板参数）加CiA 402转换表的形式表达，
+ * 与motor_api.c中MA_MAX_SLAVES的做法相同。
+ *
+ * 使用示例：
+ * @code
+ * static const StaticSlaveId ids[] = {
+ *     {0x00001097, 0x00002406, nullptr},   // EYOU，使用标准转换表
+ * };
+ * static MotorApiStatic<8> api;
+ * if (!api.init_auto(ids, 1)) return -1;
+ * while (api.running()) {
+ *     api.receive_and_process();
+ *     for (size_t m = 0; m < api.motor_count(); ++m) {
+ *         bool run = false;
+ *         api.write_control(m, api.make_control(m, api.get_status(m), run));
+ *     }
+ *     api.queue_and_send();
+ * }
+ * @endcode
+ */
+
+#include <ecrt.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "cia402_layout.hpp"
+#include "cia402_state_machine.hpp"
+#include "status_masks.hpp"
+
+/**
+ * @brief 支持的从站标识
+ */
+struct StaticSlaveId {
+    uint32_t vendor_id;         ///< 厂商ID
+    uint32_t product_code;      ///< 产品代码
+    const Cia402Table* table;   ///< 转换表，nullptr表示标准表
+};
+
+/**
+ * @brief 定容量电机控制API
+ * @tparam MaxAxes 最大轴数，不超过kMaxMaskAxes
+ * @tparam Mapping PDO映射，默认为标准CiA 402映射
+ */
+template <size_t MaxAxes, typename Mapping = Cia402Mapping>
+class MotorApiStatic {
+    static_assert(MaxAxes > 0 && MaxAxes <= kMaxMaskAxes, "MaxAxes must be in [1, kMaxMaskAxes]");
+
+    typedef typename Mapping::Rx Rx;
+    typedef typename Mapping::Tx Tx;
+
+public:
+    static const size_t kEntriesPerAxis = Rx::size + Tx::size;   ///< 每轴注册的PDO条目数
+
+    MotorApiStatic()
+        : master_(nullptr), domain_(nullptr), domain_pd_(nullptr), count_(0), run_(true) {}
+
+    ~MotorApiStatic() { cleanup(); }
+
+    /**
+     * @brief 请求主站并创建域
+     * @param master_index 主站索引
+     * @return true 成功，false 失败
+     */
+    bool request_master(unsigned int master_index = 0) {
+        master_ = ecrt_request_master(master_index);
+        if (!master_) {
+            printf("Failed to request EtherCAT master\n");
+            return false;
+        }
+        domain_ = ecrt_master_create_domain(master_);
+        if (!domain_) {
+            printf("Failed to create EtherCAT domain\n");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 添加一个轴
+     * @param position 从站位置
+     * @param vendor_id 厂商ID
+     * @param product_code 产品代码
+     * @param table 转换表，nullptr表示标准表；生命周期须长于本对象
+     * @return true 成功，false 容量已满或配置失败
+     *
+     * 须在request_master()之后、activate()之前调用
+     */
+    bool add_axis(uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                  const Cia402Table* table = nullptr) {
+        if (!master_ || count_ >= MaxAxes) return false;
+
+        ec_slave_config_t* sc = ecrt_master_slave_config(master_, 0, position, vendor_id, product_code);
+        if (!sc) {
+            printf("Failed to configure slave at position %u\n", position);
+            return false;
+        }
+        if (!Mapping::configure(sc)) {
+            printf("Failed to configure PDOs for slave at position %u\n", position);
+            return false;
+        }
+
+        Axis& axis = axes_[count_];
+        axis.position = position;
+        axis.vendor_id = vendor_id;
+        axis.product_code = product_code;
+        axis.sc = sc;
+        axis.machine.bind(table ? *table : Cia402Table::standard());
+        ++count_;
+        return true;
+    }
+
+    /**
+     * @brief 扫描总线并添加匹配的从站
+     * @param ids 支持的从站标识数组
+     * @param id_count 标识数量
+     * @return 添加的轴数量
+     *
+     * 通过ecrt_master_get_slave()读取从站信息，不调用外部命令
+     */
+    size_t scan(const StaticSlaveId* ids, size_t id_count) {
+        if (!master_) return 0;
+        ec_master_info_t info;
+        if (ecrt_master(master_, &info)) return 0;
+
+        size_t added = 0;
+        for (uint16_t pos = 0; pos < info.slave_count && count_ < MaxAxes; ++pos) {
+            ec_slave_info_t slave;
+            if (ecrt_master_get_slave(master_, pos, &slave)) continue;
+            for (size_t i = 0; i < id_count; ++i) {
+                if (ids[i].vendor_id == slave.vendor_id && ids[i].product_code == slave.product_code) {
+                    if (add_axis(pos, slave.vendor_id, slave.product_code, ids[i].table)) ++added;
+                    break;
+                }
+            }
+        }
+        return added;
+    }
+
+    /**
+     * @brief 注册PDO条目并激活主站
+     * @return true 成功，false 失败
+     */
+    bool activate() {
+        if (!master_ || count_ == 0) {
+            printf("No motor slaves configured\n");
+            return false;
+        }
+
+        size_t n = 0;
+        for (size_t m = 0; m < count_; ++m) {
+            Axis& axis = axes_[m];
+            n += Rx::fill_regs(&regs_[n], 0, axis.position, axis.vendor_id, axis.product_code,
+                               axis.offsets);
+            n += Tx::fill_regs(&regs_[n], 0, axis.position, axis.vendor_id, axis.product_code,
+                               axis.offsets + Rx::size);
+        }
+        regs_[n] = ec_pdo_entry_reg_t();
+
+        if (ecrt_domain_reg_pdo_entry_list(domain_, regs_)) {
+            printf("Failed to register PDO entries\n");
+            return false;
+        }
+        if (ecrt_master_activate(master_)) {
+            printf("Failed to activate master\n");
+            return false;
+        }
+        domain_pd_ = ecrt_domain_data(domain_);
+        if (!domain_pd_) {
+            printf("Failed to get domain data\n");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 请求主站、扫描并激活
+     * @param ids 支持的从站标识数组
+     * @param id_count 标识数量
+     * @return true 成功，false 失败
+     */
+    bool init_auto(const StaticSlaveId* ids, size_t id_count) {
+        if (!request_master()) return false;
+        scan(ids, id_count);
+        return activate();
+    }
+
+    /**
+     * @brief 接收并处理EtherCAT数据
+     *
+     * 同时采集全轴状态字并更新状态掩码
+     */
+    void receive_and_process() {
+        ecrt_master_receive(master_);
+        ecrt_domain_process(domain_);
+        for (size_t m = 0; m < count_; ++m) {
+            status_[m] = Tx::template get<0x6041>(domain_pd_, axes_[m].offsets + Rx::size);
+        }
+        compute_status_masks(status_, count_, masks_);
+    }
+
+    /**
+     * @brief 排队并发送EtherCAT数据
+     */
+    void queue_and_send() {
+        ecrt_domain_queue(domain_);
+        ecrt_master_send(master_);
+    }
+
+    /**
+     * @brief 释放主站
+     */
+    void cleanup() {
+        run_ = false;
+        if (master_) {
+            ecrt_release_master(master_);
+            master_ = nullptr;
+        }
+        domain_ = nullptr;
+        domain_pd_ = nullptr;
+        count_ = 0;
+        masks_ = StatusMasks();
+    }
+
+    /**
+     * @brief 请求停止运行
+     */
+    void stop() { run_ = false; }
+
+    /**
+     * @brief 检查运行状态
+     * @return true 运行中，false 已停止
+     */
+    bool running() const { return run_; }
+
+    /**
+     * @brief 获取电机数量
+     * @return 已配置的轴数量
+     */
+    size_t motor_count() const { return count_; }
+
+    /**
+     * @brief 获取状态字
+     * @param motor 电机索引
+     * @return 最近一次receive_and_process()采集的状态字
+     */
+    uint16_t get_status(size_t motor) const {
+        return motor < count_ ? status_[motor] : 0;
+    }
+
+    /**
+     * @brief 获取实际位置
+     * @param motor 电机索引
+     * @return 实际位置
+     */
+    int32_t get_actual_pos(size_t motor) const {
+        if (motor >= count_) return 0;
+        return Tx::template get<0x6064>(domain_pd_, axes_[motor].offsets + Rx::size);
+    }
+
+    /**
+     * @brief 获取实际速度
+     * @param motor 电机索引
+     * @return 实际速度
+     */
+    int32_t get_actual_velocity(size_t motor) const {
+        if (motor >= count_) return 0;
+        return Tx::template get<0x606C>(domain_pd_, axes_[motor].offsets + Rx::size);
+    }
+
+    /**
+     * @brief 设置操作模式
+     * @param motor 电机索引
+     * @param op_mode 操作模式
+     * @param resv1_value 保留参数值
+     */
+    void set_opmode(size_t motor, uint8_t op_mode, uint8_t resv1_value) {
+        if (motor >= count_) return;
+        Rx::template set<0x6060>(domain_pd_, axes_[motor].offsets, op_mode);
+        Rx::template set<0x60C2>(domain_pd_, axes_[motor].offsets, resv1_value);
+    }
+
+    /**
+     * @brief 写入控制字
+     * @param motor 电机索引
+     * @param control 控制字
+     */
+    void write_control(size_t motor, uint16_t control) {
+        if (motor >= count_) return;
+        Rx::template set<0x6040>(domain_pd_, axes_[motor].offsets, control);
+    }
+
+    /**
+     * @brief 更新目标位置
+     * @param motor 电机索引
+     * @param pos 目标位置
+     */
+    void update_target_pos(size_t motor, int32_t pos) {
+        if (motor >= count_) return;
+        Rx::template set<0x607A>(domain_pd_, axes_[motor].offsets, pos);
+    }
+
+    /**
+     * @brief 推进该轴的CiA 402状态机
+     * @param motor 电机索引
+     * @param status 当前状态字
+     * @param run_enable 运行使能标志引用
+     * @return 本周期应写入的控制字
+     */
+    uint16_t make_control(size_t motor, uint16_t status, bool &run_enable) {
+        if (motor >= count_) return 0;
+        return axes_[motor].machine.step(status, run_enable);
+    }
+
+    /**
+     * @brief 获取轴的CiA 402状态
+     * @param motor 电机索引
+     * @return 最近一次make_control()识别的状态
+     */
+    Cia402State get_drive_state(size_t motor) const {
+        return motor < count_ ? axes_[motor].machine.state() : Cia402State::Unknown;
+    }
+
+    /**
+     * @brief 获取全轴状态掩码
+     * @return 最近一次receive_and_process()计算的掩码
+     */
+    const StatusMasks& status_masks() const { return masks_; }
+
+    /**
+     * @brief 检查是否所有电机均已操作使能
+     */
+    bool all_enabled() const { return masks_.all(masks_.enabled); }
+
+    /**
+     * @brief 检查是否有电机处于故障
+     */
+    bool any_fault() const { return masks_.any(masks_.fault); }
+
+    /**
+     * @brief 获取域数据指针
+     * @return 域过程数据指针，激活前为nullptr
+     */
+    uint8_t* domain_data() const { return domain_pd_; }
+
+private:
+    MotorApiStatic(const MotorApiStatic&);
+    MotorApiStatic& operator=(const MotorApiStatic&);
+
+    /**
+     * @brief 单轴数据
+     */
+    struct Axis {
+        unsigned int offsets[kEntriesPerAxis];  ///< 先Rx后Tx的PDO偏移
+        Cia402StateMachine machine;             ///< CiA 402状态机
+        ec_slave_config_t* sc;                  ///< 从站配置
+        uint32_t vendor_id;                     ///< 厂商ID
+        uint32_t product_code;                  ///< 产品代码
+        uint16_t position;                      ///< 从站位置
+    };
+
+    ec_master_t* master_;                                   ///< EtherCAT主站句柄
+    ec_domain_t* domain_;                                   ///< EtherCAT域句柄
+    uint8_t* domain_pd_;                                    ///< 域过程数据指针
+    size_t count_;                                          ///< 已配置的轴数量
+    bool run_;                                              ///< 运行状态标志
+    Axis axes_[MaxAxes];                                    ///< 单轴数据
+    uint16_t status_[MaxAxes];                              ///< 本周期状态字
+    StatusMasks masks_;                                     ///< 全轴状态掩码
+    ec_pdo_entry_reg_t regs_[MaxAxes * kEntriesPerAxis + 1];  ///< PDO条目注册表
+};
+
+template <size_t MaxAxes, typename Mapping>
+const size_t MotorApiStatic<MaxAxes, Mapping>::kEntriesPerAxis;
+
+#endif // MOTOR_API_STATIC_HPP
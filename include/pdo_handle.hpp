@@ -0,0 +1,79 @@
+#ifndef PDO_HANDLE_HPP
+#define PDO_HANDLE_HPP
+
+/**
+ * @file pdo_handle.hpp
+ * @brief 类型化PDO条目句柄
+ *
+ * 句柄在初始化阶段由MotorApi::map_entry()解析，保存对象在域内的字节偏移。
+ * 周期内的read()/write()为一次非对齐小端读写，不查表、不分配内存。
+ */
+
+#include <stdint.h>
+#include "axis_data.hpp"
+#include "pdo_layout.hpp"
+
+/**
+ * @brief 类型化PDO条目句柄
+ * @tparam T 条目数据类型，位长度须与映射一致
+ *
+ * 使用示例：
+ * @code
+ * PdoHandle<int32_t> velocity = api.map_entry<int32_t>(0, 0x606C);
+ * if (velocity.valid()) {
+ *     int32_t v = velocity.read(api.domain_data());
+ * }
+ * @endcode
+ *
+ * 只能解析适配器PDO映射中已有的对象；如需跟随误差（0x60F4）等其他对象，
+ * 须先把它加入适配器的TxPDO映射。
+ */
+template <typename T>
+class PdoHandle {
+public:
+    /**
+     * @brief 构造无效句柄
+     */
+    PdoHandle() : offset_(kNoPdoSlot) {}
+
+    /**
+     * @brief 由域内偏移量构造句柄
+     * @param offset 域内字节偏移
+     */
+    explicit PdoHandle(unsigned int offset) : offset_(offset) {}
+
+    /**
+     * @brief 检查句柄是否有效
+     * @return true 已解析到映射条目，false 条目不存在或类型不匹配
+     */
+    bool valid() const { return offset_ != kNoPdoSlot; }
+
+    /**
+     * @brief 获取域内偏移量
+     * @return 字节偏移，无效句柄返回kNoPdoSlot
+     */
+    unsigned int offset() const { return offset_; }
+
+    /**
+     * @brief 读取条目值
+     * @param domain_pd 域过程数据指针
+     * @return 条目值
+     *
+     * 调用前须确认valid()，周期内不再检查
+     */
+    T read(const uint8_t* domain_pd) const { return pdo_load<T>(domain_pd + offset_); }
+
+    /**
+     * @brief 写入条目值
+     * @param domain_pd 域过程数据指针
+     * @param value 条目值
+     *
+     * 调用前须确认valid()，周期内不再检查
+     */
+    void write(uint8_t* domain_pd, T value) const { pdo_store<T>(domain_pd + offset_, value); }
+
+private:
+    unsigned int offset_;   ///< 域内字节偏移
+};
+
+#endif // PDO_HANDLE_HPP
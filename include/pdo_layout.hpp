@@ -0,0 +1,279 @@
+#ifndef PDO_LAYOUT_HPP
+#define PDO_LAYOUT_HPP
+
+/**
+ * @file pdo_layout.hpp
+ * @brief 编译期PDO布局模板
+ *
+ * 用一份类型列表同时描述PDO条目的对象索引、数据类型和顺序，由此生成：
+ * - 编译期常量的字段位置
+ * - 按类型内联的非对齐小端读写函数
+ * - 对应的ec_pdo_entry_info_t / ec_pdo_info_t / ec_sync_info_t 配置表
+ * - 对应的ec_pdo_entry_reg_t 注册条目
+ *
+ * 使用示例：
+ * @code
+ * typedef PdoLayout<PdoEntry<0x6040, uint16_t>, PdoEntry<0x607A, int32_t> > RxLayout;
+ * typedef PdoLayout<PdoEntry<0x6041, uint16_t>, PdoEntry<0x6064, int32_t> > TxLayout;
+ * typedef PdoMapping<0x1600, RxLayout, 0x1A00, TxLayout> Mapping;
+ *
+ * Mapping::configure(slave_config);
+ * uint16_t status = TxLayout::get<0x6041>(domain_pd, tx_offsets);
+ * RxLayout::set<0x607A>(domain_pd, rx_offsets, target);
+ * @endcode
+ */
+
+#include <ecrt.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+namespace pdo_detail {
+
+/**
+ * @brief 按字节宽度选择的字节序转换
+ *
+ * EtherCAT过程数据为小端格式，小端主机上转换为空操作。
+ */
+template <size_t Bytes> struct LeSwap;
+
+template <> struct LeSwap<1> {
+    static uint8_t apply(uint8_t v) { return v; }
+};
+
+template <> struct LeSwap<2> {
+    static uint16_t apply(uint16_t v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return __builtin_bswap16(v);
+#else
+        return v;
+#endif
+    }
+};
+
+template <> struct LeSwap<4> {
+    static uint32_t apply(uint32_t v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return __builtin_bswap32(v);
+#else
+        return v;
+#endif
+    }
+};
+
+template <> struct LeSwap<8> {
+    static uint64_t apply(uint64_t v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return __builtin_bswap64(v);
+#else
+        return v;
+#endif
+    }
+};
+
+/**
+ * @brief 与类型等宽的无符号整数
+ */
+template <size_t Bytes> struct UintOf;
+template <> struct UintOf<1> { typedef uint8_t type; };
+template <> struct UintOf<2> { typedef uint16_t type; };
+template <> struct UintOf<4> { typedef uint32_t type; };
+template <> struct UintOf<8> { typedef uint64_t type; };
+
+/**
+ * @brief 在条目列表中查找指定对象
+ *
+ * 找到时提供position（在列表中的位置）与type（数据类型），
+ * 找不到时编译报错。
+ */
+template <uint16_t Index, uint8_t Subindex, size_t Position, typename... Entries>
+struct Find;
+
+template <uint16_t Index>
+struct DependentFalse {
+    static const bool value = false;
+};
+
+template <uint16_t Index, uint8_t Subindex, size_t Position>
+struct Find<Index, Subindex, Position> {
+    static_assert(DependentFalse<Index>::value, "PDO entry is not part of this layout");
+};
+
+template <size_t Position, typename Entry>
+struct Found {
+    static const size_t position = Position;
+    typedef typename Entry::type type;
+};
+
+template <uint16_t Index, uint8_t Subindex, size_t Position, typename Head, typename... Tail>
+struct Find<Index, Subindex, Position, Head, Tail...>
+    : std::conditional<Head::index == Index && Head::subindex == Subindex,
+                       Found<Position, Head>,
+                       Find<Index, Subindex, Position + 1, Tail...> >::type {};
+
+} // namespace pdo_detail
+
+/**
+ * @brief 非对齐小端读取
+ * @param data 字节数据指针
+ * @return 转换后的本地值
+ */
+template <typename T>
+inline T pdo_load(const uint8_t* data) {
+    typedef typename pdo_detail::UintOf<sizeof(T)>::type U;
+    U raw;
+    memcpy(&raw, data, sizeof(U));
+    raw = pdo_detail::LeSwap<sizeof(T)>::apply(raw);
+    T value;
+    memcpy(&value, &raw, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief 非对齐小端写入
+ * @param data 字节数据指针
+ * @param value 待写入的本地值
+ */
+template <typename T>
+inline void pdo_store(uint8_t* data, T value) {
+    typedef typename pdo_detail::UintOf<sizeof(T)>::type U;
+    U raw;
+    memcpy(&raw, &value, sizeof(T));
+    raw = pdo_detail::LeSwap<sizeof(T)>::apply(raw);
+    memcpy(data, &raw, sizeof(U));
+}
+
+/**
+ * @brief PDO条目描述
+ * @tparam Index 对象索引
+ * @tparam T 数据类型，位长度由sizeof(T)推出
+ * @tparam Subindex 子索引
+ */
+template <uint16_t Index, typename T, uint8_t Subindex = 0x00>
+struct PdoEntry {
+    typedef T type;
+    static const uint16_t index = Index;
+    static const uint8_t subindex = Subindex;
+    static const uint8_t bit_length = sizeof(T) * 8;
+};
+
+/**
+ * @brief PDO布局
+ * @tparam Entries PdoEntry列表，顺序即PDO映射顺序
+ *
+ * 偏移量数组与条目一一对应，由fill_regs()注册时填充。
+ */
+template <typename... Entries>
+struct PdoLayout {
+    static const size_t size = sizeof...(Entries);   ///< 条目数量
+
+    static ec_pdo_entry_info_t entries[sizeof...(Entries)];  ///< ecrt条目信息表
+
+    /**
+     * @brief 字段信息
+     *
+     * field<Index>::position 为编译期字段位置，field<Index>::type 为字段类型
+     */
+    template <uint16_t Index, uint8_t Subindex = 0x00>
+    struct field : pdo_detail::Find<Index, Subindex, 0, Entries...> {};
+
+    /**
+     * @brief 读取字段
+     * @param domain_pd 域过程数据指针
+     * @param offsets 本布局的偏移量数组
+     * @return 字段值
+     */
+    template <uint16_t Index, uint8_t Subindex = 0x00>
+    static typename field<Index, Subindex>::type get(const uint8_t* domain_pd, const unsigned int* offsets) {
+        typedef field<Index, Subindex> F;
+        return pdo_load<typename F::type>(domain_pd + offsets[F::position]);
+    }
+
+    /**
+     * @brief 写入字段
+     * @param domain_pd 域过程数据指针
+     * @param offsets 本布局的偏移量数组
+     * @param value 字段值
+     */
+    template <uint16_t Index, uint8_t Subindex = 0x00>
+    static void set(uint8_t* domain_pd, const unsigned int* offsets,
+                    typename field<Index, Subindex>::type value) {
+        typedef field<Index, Subindex> F;
+        pdo_store<typename F::type>(domain_pd + offsets[F::position], value);
+    }
+
+    /**
+     * @brief 生成PDO条目注册项
+     * @param regs 输出数组，至少size个元素
+     * @param alias 从站别名
+     * @param position 从站位置
+     * @param vendor_id 厂商ID
+     * @param product_code 产品代码
+     * @param offsets 偏移量数组，注册成功后由ecrt填充
+     * @return 写入的注册项数量
+     */
+    static size_t fill_regs(ec_pdo_entry_reg_t* regs, uint16_t alias, uint16_t position,
+                            uint32_t vendor_id, uint32_t product_code, unsigned int* offsets) {
+        for (size_t i = 0; i < size; ++i) {
+            ec_pdo_entry_reg_t reg = {alias, position, vendor_id, product_code,
+                                      entries[i].index, entries[i].subindex, &offsets[i], NULL};
+            regs[i] = reg;
+        }
+        return size;
+    }
+};
+
+template <typename... Entries>
+ec_pdo_entry_info_t PdoLayout<Entries...>::entries[sizeof...(Entries)] = {
+    {Entries::index, Entries::subindex, Entries::bit_length}...
+};
+
+/**
+ * @brief PDO映射与同步管理器配置
+ * @tparam RxIndex RxPDO索引（如0x1600）
+ * @tparam RxLayout 输出方向布局
+ * @tparam TxIndex TxPDO索引（如0x1A00）
+ * @tparam TxLayout 输入方向布局
+ *
+ * SM0/SM1为邮箱，SM2输出RxPDO并启用看门狗，SM3输入TxPDO
+ */
+template <uint16_t RxIndex, typename RxLayout, uint16_t TxIndex, typename TxLayout>
+struct PdoMapping {
+    typedef RxLayout Rx;
+    typedef TxLayout Tx;
+
+    static ec_pdo_info_t rx_pdos[1];         ///< RxPDO定义
+    static ec_pdo_info_t tx_pdos[1];         ///< TxPDO定义
+    static const ec_sync_info_t syncs[5];    ///< 同步管理器配置
+
+    /**
+     * @brief 将映射写入从站配置
+     * @param slave_config 从站配置句柄
+     * @return true 成功，false 失败
+     */
+    static bool configure(ec_slave_config_t* slave_config) {
+        return ecrt_slave_config_pdos(slave_config, EC_END, syncs) == 0;
+    }
+};
+
+template <uint16_t RxIndex, typename RxLayout, uint16_t TxIndex, typename TxLayout>
+ec_pdo_info_t PdoMapping<RxIndex, RxLayout, TxIndex, TxLayout>::rx_pdos[1] = {
+    {RxIndex, RxLayout::size, RxLayout::entries},
+};
+
+template <uint16_t RxIndex, typename RxLayout, uint16_t TxIndex, typename TxLayout>
+ec_pdo_info_t PdoMapping<RxIndex, RxLayout, TxIndex, TxLayout>::tx_pdos[1] = {
+    {TxIndex, TxLayout::size, TxLayout::entries},
+};
+
+template <uint16_t RxIndex, typename RxLayout, uint16_t TxIndex, typename TxLayout>
+const ec_sync_info_t PdoMapping<RxIndex, RxLayout, TxIndex, TxLayout>::syncs[5] = {
+    {0, EC_DIR_OUTPUT, 0, NULL, EC_WD_DISABLE},
+    {1, EC_DIR_INPUT, 0, NULL, EC_WD_DISABLE},
+    {2, EC_DIR_OUTPUT, 1, rx_pdos, EC_WD_ENABLE},
+    {3, EC_DIR_INPUT, 1, tx_pdos, EC_WD_DISABLE},
+    {0xff, EC_DIR_INVALID, 0, NULL, EC_WD_DEFAULT}
+};
+
+#endif // PDO_LAYOUT_HPP
@@ -0,0 +1,141 @@
+#ifndef SETPOINT_STREAM_HPP
+#define SETPOINT_STREAM_HPP
+
+/**
+ * @file setpoint_stream.hpp
+ * @brief 单轴设定值流
+ *
+ * 规划线程（生产者）把带时间戳的目标位置成批写入无锁单生产者/单消费者环形队列，
+ * 周期循环（消费者）每周期取出一个。规划的抖动被队列吸收，不再传到总线周期上，
+ * 规划线程也可以一次生成一大批设定值。队列为空（欠载）时按策略保持或外推目标位置，
+ * 欠载次数与队列水位可在任意线程读取。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <atomic>
+#include "axis_data.hpp"
+
+/**
+ * @brief 带时间戳的设定值
+ */
+struct Setpoint {
+    uint64_t timestamp_ns;  ///< 计划生效时刻（CLOCK_MONOTONIC纳秒），仅用于统计提前量，0表示不统计
+    int32_t position;       ///< 目标位置
+};
+
+/**
+ * @brief 欠载时的目标位置策略
+ */
+enum class UnderrunPolicy {
+    Hold,           ///< 保持最后一个目标位置
+    Extrapolate     ///< 按最后两个设定值之差外推，超过外推上限后保持
+};
+
+/**
+ * @brief 设定值流配置
+ */
+struct SetpointStreamConfig {
+    size_t capacity;            ///< 队列容量，向上取整为2的幂
+    UnderrunPolicy policy;      ///< 欠载策略
+    uint32_t max_extrapolate;   ///< 连续欠载时最多外推的周期数，之后保持
+
+    SetpointStreamConfig() : capacity(1024), policy(UnderrunPolicy::Hold), max_extrapolate(10) {}
+};
+
+/**
+ * @brief 设定值流统计（可在任意线程读取）
+ */
+struct SetpointStreamStats {
+    uint64_t consumed;              ///< 已消费的设定值数
+    uint64_t underruns;             ///< 欠载事件数（从有数据变为无数据的次数）
+    uint64_t underrun_cycles;       ///< 欠载周期数
+    uint32_t consecutive_underruns; ///< 当前连续欠载周期数，0表示未欠载
+    size_t fill;                    ///< 当前队列水位
+    size_t min_fill;                ///< 开始消费以来每周期取数前的最低水位
+    int64_t last_lead_ns;           ///< 最近一个设定值的时间戳减去取出时刻，负值表示设定值已过期
+};
+
+/**
+ * @brief 单轴设定值流
+ *
+ * push()只能由一个生产者线程调用，next()只能由周期循环调用，两侧都不加锁、不等待。
+ */
+class SetpointStream {
+public:
+    /**
+     * @brief 构造设定值流
+     * @param config 配置
+     */
+    explicit SetpointStream(const SetpointStreamConfig& config);
+
+    /**
+     * @brief 写入一个设定值（生产者）
+     * @return true 成功，false 队列已满
+     */
+    bool push(const Setpoint& setpoint);
+
+    /**
+     * @brief 成批写入设定值（生产者）
+     * @param setpoints 设定值数组
+     * @param count 数量
+     * @return 实际写入的数量，队列满时少于count
+     */
+    size_t push(const Setpoint* setpoints, size_t count);
+
+    /**
+     * @brief 取出本周期的目标位置（周期循环）
+     * @param now_ns 当前时间，用于统计提前量
+     * @param target 输出目标位置
+     * @return true 应写入target，false 尚未收到过设定值（不写目标位置）
+     *
+     * 队列非空时取出一个设定值；为空时计一次欠载，按策略保持或外推
+     */
+    bool next(uint64_t now_ns, int32_t& target);
+
+    /**
+     * @brief 获取当前队列水位
+     */
+    size_t fill() const;
+
+    /**
+     * @brief 获取队列容量
+     */
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief 获取统计
+     */
+    SetpointStreamStats stats() const;
+
+private:
+    SetpointStream(const SetpointStream&);
+    SetpointStream& operator=(const SetpointStream&);
+
+    std::vector<Setpoint> ring_;    ///< 环形缓冲区
+    size_t mask_;                   ///< 容量-1
+    SetpointStreamConfig config_;   ///< 配置
+
+    // 生产者写head_，消费者写tail_，各自连同只由本侧访问的缓存占一整行
+    // （用填充而非alignas的原因见kCacheLineSize）
+    std::atomic<size_t> head_;      ///< 下一个写入位置（生产者）
+    size_t cached_tail_;            ///< 生产者缓存的消费位置
+    char pad0_[kCacheLineSize];     ///< 缓存行填充
+    std::atomic<size_t> tail_;      ///< 下一个读取位置（消费者）
+    size_t cached_head_;            ///< 消费者缓存的写入位置
+    char pad1_[kCacheLineSize];     ///< 缓存行填充
+
+    // 以下只由消费者写
+    bool primed_;                   ///< 是否已收到过设定值
+    int32_t last_;                  ///< 最近输出的目标位置
+    int32_t delta_;                 ///< 最近两个设定值之差
+    std::atomic<uint64_t> consumed_;            ///< 已消费数
+    std::atomic<uint64_t> underruns_;           ///< 欠载事件数
+    std::atomic<uint64_t> underrun_cycles_;     ///< 欠载周期数
+    std::atomic<uint32_t> consecutive_;         ///< 当前连续欠载周期数
+    std::atomic<size_t> min_fill_;              ///< 最低水位
+    std::atomic<int64_t> last_lead_ns_;         ///< 最近的提前量
+};
+
+#endif // SETPOINT_STREAM_HPP
@@ -0,0 +1,130 @@
+#ifndef STATUS_MASKS_HPP
+#define STATUS_MASKS_HPP
+
+/**
+ * @file status_masks.hpp
+ * @brief 全轴状态位掩码
+ *
+ * 每周期将所有轴的状态字压缩为若干64位掩码，第m位对应第m个轴。
+ * "是否全部使能"、"是否有轴故障"等组判断只需一次按位运算，与轴数量无关。
+ * 支持SSE2时每次并行比较16个状态字，否则逐个比较。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief 掩码可表示的最大轴数
+ */
+static const size_t kMaxMaskAxes = 64;
+
+/**
+ * @brief 全轴状态位掩码
+ */
+struct StatusMasks {
+    uint64_t axes;              ///< 参与统计的轴
+    uint64_t enabled;           ///< 操作使能 (sw & 0x6F) == 0x27
+    uint64_t fault;             ///< 故障位 0x0008
+    uint64_t warning;           ///< 警告位 0x0080
+    uint64_t target_reached;    ///< 目标到达位 0x0400
+    uint64_t following_error;   ///< 跟随误差位 0x2000
+    uint64_t quick_stop;        ///< 快速停止激活 (sw & 0x6F) == 0x07
+
+    StatusMasks()
+        : axes(0), enabled(0), fault(0), warning(0),
+          target_reached(0), following_error(0), quick_stop(0) {}
+
+    /**
+     * @brief 判断所有轴是否都在掩码中
+     * @param mask 状态掩码
+     * @return 至少有一个轴且全部置位时返回true
+     */
+    bool all(uint64_t mask) const { return axes != 0 && (mask & axes) == axes; }
+
+    /**
+     * @brief 判断是否有轴在掩码中
+     * @param mask 状态掩码
+     * @return 任一轴置位时返回true
+     */
+    bool any(uint64_t mask) const { return (mask & axes) != 0; }
+
+    /**
+     * @brief 判断是否没有轴在掩码中
+     * @param mask 状态掩码
+     * @return 全部未置位时返回true
+     */
+    bool none(uint64_t mask) const { return (mask & axes) == 0; }
+};
+
+namespace status_detail {
+
+/**
+ * @brief 逐个比较 (status[i] & mask) == value
+ * @return 第i位表示第i个状态字是否命中
+ */
+inline uint64_t match_scalar(const uint16_t* status, size_t count, uint16_t mask, uint16_t value) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bits |= static_cast<uint64_t>((status[i] & mask) == value) << i;
+    }
+    return bits;
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief 并行比较16个状态字
+ * @return 低16位为比较结果
+ */
+inline uint32_t match16(const uint16_t* status, __m128i mask, __m128i value) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(status));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(status + 8));
+    lo = _mm_cmpeq_epi16(_mm_and_si128(lo, mask), value);
+    hi = _mm_cmpeq_epi16(_mm_and_si128(hi, mask), value);
+    // 比较结果为0或-1，饱和压缩为字节后每个状态字对应一位
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+}
+#endif
+
+/**
+ * @brief 计算 (status[i] & mask) == value 的位掩码
+ */
+inline uint64_t match(const uint16_t* status, size_t count, uint16_t mask, uint16_t value) {
+    uint64_t bits = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i vmask = _mm_set1_epi16(static_cast<short>(mask));
+    const __m128i vvalue = _mm_set1_epi16(static_cast<short>(value));
+    for (; i + 16 <= count; i += 16) {
+        bits |= static_cast<uint64_t>(match16(status + i, vmask, vvalue)) << i;
+    }
+#endif
+    if (i < count) {
+        bits |= match_scalar(status + i, count - i, mask, value) << i;
+    }
+    return bits;
+}
+
+} // namespace status_detail
+
+/**
+ * @brief 由状态字数组计算全轴状态掩码
+ * @param status 状态字数组
+ * @param count 轴数量，超过kMaxMaskAxes的部分不参与统计
+ * @param out 输出掩码
+ */
+inline void compute_status_masks(const uint16_t* status, size_t count, StatusMasks& out) {
+    using status_detail::match;
+    if (count > kMaxMaskAxes) count = kMaxMaskAxes;
+    out.axes = count >= 64 ? ~0ULL : ((1ULL << count) - 1);
+    out.enabled = match(status, count, 0x006F, 0x0027);
+    out.fault = match(status, count, 0x0008, 0x0008);
+    out.warning = match(status, count, 0x0080, 0x0080);
+    out.target_reached = match(status, count, 0x0400, 0x0400);
+    out.following_error = match(status, count, 0x2000, 0x2000);
+    out.quick_stop = match(status, count, 0x006F, 0x0007);
+}
+
+#endif // STATUS_MASKS_HPP
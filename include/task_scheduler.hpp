@@ -0,0 +1,102 @@
+#ifndef TASK_SCHEDULER_HPP
+#define TASK_SCHEDULER_HPP
+
+/**
+ * @file task_scheduler.hpp
+ * @brief 基于总线周期的多速率任务调度
+ *
+ * 任务以分频数和相位注册，在cycle % divisor == phase的周期执行。
+ * 未指定相位时自动选择与已注册任务重叠最少的相位，使慢任务分散到不同周期，
+ * 单周期最坏耗时为一个时隙内任务之和，而不是所有任务之和。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+/**
+ * @brief 多速率任务调度器
+ */
+class TaskScheduler {
+public:
+    /**
+     * @brief 任务函数，参数为当前周期号
+     */
+    typedef std::function<void(uint64_t cycle)> Task;
+
+    static const uint32_t kAutoPhase = 0xFFFFFFFFu;    ///< 自动选择相位
+
+    /**
+     * @brief 任务信息与耗时统计
+     */
+    struct TaskInfo {
+        std::string name;       ///< 任务名
+        uint32_t divisor;       ///< 分频数，每divisor个周期执行一次
+        uint32_t phase;         ///< 相位，0 <= phase < divisor
+        uint64_t runs;          ///< 执行次数
+        uint64_t last_ns;       ///< 最近一次耗时
+        uint64_t max_ns;        ///< 最大耗时
+    };
+
+    /**
+     * @brief 注册任务
+     * @param name 任务名
+     * @param divisor 分频数，0按1处理
+     * @param task 任务函数
+     * @param phase 相位，kAutoPhase表示自动选择；超出范围时取模
+     * @return 任务索引
+     *
+     * 应在周期循环开始前注册
+     */
+    size_t add(const std::string& name, uint32_t divisor, const Task& task, uint32_t phase = kAutoPhase);
+
+    /**
+     * @brief 移除所有任务
+     */
+    void clear();
+
+    /**
+     * @brief 执行本周期到期的任务
+     * @param cycle 周期号
+     */
+    void run(uint64_t cycle);
+
+    /**
+     * @brief 获取任务数量
+     */
+    size_t size() const { return tasks_.size(); }
+
+    /**
+     * @brief 获取任务信息
+     * @param index 任务索引
+     */
+    const TaskInfo& info(size_t index) const { return tasks_[index].info; }
+
+    /**
+     * @brief 计算单个周期内最多同时到期的任务数
+     * @return 所有周期中到期任务数的最大值
+     */
+    size_t worst_slot_load() const;
+
+    /**
+     * @brief 由时间间隔计算分频数
+     * @param period_ns 总线周期（纳秒）
+     * @param interval_ns 期望的任务间隔（纳秒）
+     * @return 分频数，不小于1
+     */
+    static uint32_t divisor_for(uint64_t period_ns, uint64_t interval_ns);
+
+private:
+    struct Entry {
+        TaskInfo info;
+        Task fn;
+    };
+
+    uint32_t pick_phase(uint32_t divisor) const;
+
+    std::vector<Entry> tasks_;  ///< 已注册任务
+};
+
+#endif // TASK_SCHEDULER_HPP
@@ -15,7 +15,7 @@ public:
     MotorInfo getMotorInfo() const override;
     bool supportsMotor(uint32_t vendor_id, uint32_t product_code) const override;
     std::string getName() const override;
-    uint16_t makeControl(uint16_t status, int32_t &start_pos, bool &run_enable) const override;
+    const Cia402Table& stateTable() const override;
 };
 
 /**
@@ -16,9 +16,17 @@ int main(int argc, char **argv) {
     /* 固定500步长，正向运行 */
     motor_api_set_command(h, true, 1, 500);
     signal(SIGINT, sig_handler); signal(SIGTERM, sig_handler);
-    while (!stop) { motor_api_run_once(h); usleep(4000); }
+    /* 实时周期线程：SCHED_FIFO 80、锁内存、预触碰 64KB 栈，周期取创建时的 4ms；
+       4ms 周期只睡眠即可，亚毫秒周期再设置自旋提前量与发送偏移；超时保位，连续 10 次超时快速停止 */
+    ma_rt_config_t rt = { 80, -1, true, 64 * 1024, 0, 0, MA_OVERRUN_HOLD, 10, false };
+    if (motor_api_start_cyclic(h, &rt) != MA_OK) { fprintf(stderr, "motor_api_start_cyclic failed\n"); motor_api_destroy(h); return 1; }
+    /* 看门狗：优先级低于周期线程，5 个周期（20ms）无心跳即快速停止 */
+    ma_watchdog_config_t wd = { 4000, 20000, 40, -1 };
+    if (motor_api_start_watchdog(h, &wd) != MA_OK) fprintf(stderr, "motor_api_start_watchdog failed, running unsupervised\n");
+    while (!stop) pause();
     /* 退出前停止并销毁 */
     motor_api_set_command(h, false, 0, 0);
+    motor_api_stop_cyclic(h);
     motor_api_destroy(h);
     return 0;
 }
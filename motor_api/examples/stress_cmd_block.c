@@ -0,0 +1,72 @@
+/*
+ * 文件: stress_cmd_block.c
+ * 功能: 命令三缓冲压力测试，不需要 EtherCAT 硬件。
+ *       写者线程按库内的方式（持 cmd_mutex 修改命令后 publish_cmd_locked）连续发布命令块，
+ *       块内全部字段写入同一个序号；读者按周期线程的方式反复 acquire_cmd，
+ *       检查读到的块字段一致（无撕裂）、序号不回退，且写者结束后读到最后一次发布。
+ * 用法: ./stress_cmd_block [发布次数=5000000]
+ * 返回: 0 通过；1 发现撕裂、回退或未读到最后一次发布
+ */
+
+/* 直接编入库源文件以访问内部的三缓冲函数，本目标不链接 motor_api 库 */
+#include "../src/motor_api.c"
+
+static int publish_count = 5000000;
+static volatile int writer_done = 0;
+
+/*
+ * 函数: writer_fn
+ * 功能: 写者线程：发布序号 1..n 的命令块。
+ */
+static void *writer_fn(void *arg) {
+    motor_api_handle_t *h = (motor_api_handle_t *)arg;
+    const int n = publish_count;
+    for (int v = 1; v <= n; ++v) {
+        pthread_mutex_lock(&h->cmd_mutex);
+        h->cmd.global.step = v;
+        for (int i = 0; i < MA_MAX_SLAVES; ++i) h->cmd.axis[i].step = v;
+        h->cmd.axis_override = (uint32_t)v;
+        publish_cmd_locked(h);
+        pthread_mutex_unlock(&h->cmd_mutex);
+        if (!(v & 1023)) sched_yield();
+    }
+    __atomic_store_n(&writer_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) publish_count = atoi(argv[1]);
+    const int n = publish_count;
+    if (n <= 0) { fprintf(stderr, "invalid count\n"); return 1; }
+
+    motor_api_handle_t *h = (motor_api_handle_t *)calloc(1, sizeof(*h)); if (!h) return 1;
+    pthread_mutex_init(&h->cmd_mutex, NULL);
+    h->cmd_back = 0; h->cmd_middle = 1; h->cmd_front = 2;
+
+    pthread_t writer;
+    if (pthread_create(&writer, NULL, writer_fn, h) != 0) { fprintf(stderr, "pthread_create failed\n"); return 1; }
+
+    unsigned long long reads = 0, torn = 0, backwards = 0, stale = 0;
+    int last = 0;
+    for (;;) {
+        const int done = __atomic_load_n(&writer_done, __ATOMIC_ACQUIRE);
+        const ma_command_block_t *cmd = acquire_cmd(h);
+        const int v = cmd->global.step;
+        int bad = (uint32_t)v != cmd->axis_override;
+        for (int i = 0; i < MA_MAX_SLAVES; ++i) bad |= cmd->axis[i].step != v;
+        if (bad) ++torn;
+        if (v < last) ++backwards;
+        last = v;
+        ++reads;
+        /* 写者结束后的第一次读取必须取得最后一次发布 */
+        if (done) { if (v != n) stale = 1; break; }
+        if (!(reads & 1023)) sched_yield();
+    }
+    pthread_join(writer, NULL);
+    pthread_mutex_destroy(&h->cmd_mutex);
+    free(h);
+
+    printf("stress_cmd_block: %d publishes, %llu reads, %llu torn, %llu backwards, final %s\n", n, reads, torn, backwards,
+           stale ? "missed" : "ok");
+    return (torn || backwards || stale) ? 1 : 0;
+}
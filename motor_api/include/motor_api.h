@@ -8,6 +8,16 @@
  * 修改历史:
  *   - 2025-11-28: 初始版本，支持 ENI 读取、DC 同步、CSP 控制、HTTP 服务。
  *   - 2025-11-28: 增加“全轴使能后延时 1s 同步起动”的栅栏机制。
+ *   - 2026-10-15: 增加全轴状态位掩码查询接口。
+ *   - 2026-10-15: 增加绝对截止时间驱动的实时周期线程（motor_api_start_cyclic）。
+ *   - 2026-10-15: 增加周期各阶段耗时直方图查询接口，诊断 JSON 附带耗时统计。
+ *   - 2026-10-15: 实时周期线程支持睡眠+自旋混合等待与固定发送偏移，统计发送抖动。
+ *   - 2026-10-15: 实时周期线程增加超时降级策略与连续超时受控停机（motor_api_get_overruns）。
+ *   - 2026-10-15: 增加带外看门狗线程，周期停滞时受控停机并输出诊断。
+ *   - 2026-10-15: 增加多速率任务表（motor_api_add_task），状态检查按分频错相执行。
+ *   - 2026-10-15: 增加周期定时器 timerfd 与周期完成 eventfd，可由外部 epoll 循环驱动周期；
+ *                 每周期以序列锁发布快照，可非阻塞读取（motor_api_poll_snapshot）。
+ *   - 2026-10-15: 运行命令改为无锁发布，周期线程不再等待命令互斥；增加按轴命令。
  */
 
 #ifndef MOTOR_API_H
@@ -67,6 +77,218 @@ typedef enum {
     MA_MODE_CST = 10
 } ma_operate_mode_t;
 
+/*
+ * 结构: ma_status_masks_t
+ * 功能: 全轴状态位掩码，第 i 位对应第 i 个从站，每周期由 motor_api_run_once 更新。
+ * 字段:
+ *   - axes: 参与统计的从站
+ *   - enabled: 操作使能（状态字 & 0x6F == 0x27）
+ *   - fault: 故障位 0x0008
+ *   - warning: 警告位 0x0080
+ *   - target_reached: 目标到达位 0x0400
+ *   - following_error: 跟随误差位 0x2000
+ *   - quick_stop: 快速停止激活（状态字 & 0x6F == 0x07）
+ * 使用示例:
+ *   全部使能: (m.enabled & m.axes) == m.axes
+ *   存在故障: (m.fault & m.axes) != 0
+ */
+typedef struct {
+    uint32_t axes;
+    uint32_t enabled;
+    uint32_t fault;
+    uint32_t warning;
+    uint32_t target_reached;
+    uint32_t following_error;
+    uint32_t quick_stop;
+} ma_status_masks_t;
+
+/*
+ * 超时降级策略枚举
+ * 功能: 周期超时（上一周期的工作越过了本周期截止时间）后本周期的处理方式。
+ * 成员含义:
+ *   - MA_OVERRUN_RUN: 照常计算，只计数
+ *   - MA_OVERRUN_RESEND: 跳过计算，重发上一周期的输出
+ *   - MA_OVERRUN_HOLD: 跳过计算，已使能轴的目标位置保持在实际位置
+ *   - MA_OVERRUN_EXTRAPOLATE: 跳过计算，已使能轴按上一周期的目标增量外推
+ */
+typedef enum {
+    MA_OVERRUN_RUN = 0,
+    MA_OVERRUN_RESEND = 1,
+    MA_OVERRUN_HOLD = 2,
+    MA_OVERRUN_EXTRAPOLATE = 3
+} ma_overrun_policy_t;
+
+/*
+ * 结构: ma_rt_config_t
+ * 功能: 实时周期线程配置，周期取 motor_api_create 的 cycle_us。
+ * 字段:
+ *   - priority: SCHED_FIFO 优先级（1-99），0 表示使用默认调度策略
+ *   - cpu: 绑定的 CPU 编号，-1 表示不绑定
+ *   - lock_memory: 是否 mlockall(MCL_CURRENT | MCL_FUTURE)
+ *   - prefault_stack: 线程启动时预触碰的栈字节数，0 表示不预触碰
+ *   - spin_margin_ns: 截止时间前改为自旋等待的提前量，0 表示只睡眠
+ *   - send_offset_ns: 发送时刻相对周期起点的偏移，0 表示计算完成后立即发送
+ *   - overrun_policy: 周期超时后的降级策略
+ *   - overrun_stop_after: 连续超时达到该次数时受控停机（全轴保位并写 0x0002），0 表示不停机
+ *   - pipelined: 流水线模式，接收后立即发送上一周期算好的输出，再计算下一帧的输出
+ * 说明: 250-500µs 周期建议 spin_margin_ns 取 30000-80000，send_offset_ns 取略大于
+ *       接收+计算耗时 p99.9 的值（见 motor_api_get_timing）。
+ *       流水线模式下帧发出时刻只取决于接收耗时，send_offset_ns 取略大于接收耗时即可，
+ *       代价是目标位置晚一个周期生效，适合 DC 同步的 CSP。
+ */
+typedef struct {
+    int priority;
+    int cpu;
+    bool lock_memory;
+    size_t prefault_stack;
+    uint32_t spin_margin_ns;
+    uint32_t send_offset_ns;
+    ma_overrun_policy_t overrun_policy;
+    uint32_t overrun_stop_after;
+    bool pipelined;
+} ma_rt_config_t;
+
+/*
+ * 周期阶段枚举
+ * 功能: 标识耗时统计的阶段。
+ * 成员含义:
+ *   - MA_TIMING_WAKEUP: 唤醒延迟，实际唤醒时间与截止时间之差（实时周期线程与 motor_api_dispatch_timer）
+ *   - MA_TIMING_RECEIVE: 接收、域处理、状态检查与状态字采集
+ *   - MA_TIMING_COMPUTE: 状态机推进、目标更新与同步栅栏
+ *   - MA_TIMING_SEND: 域排队与发送
+ *   - MA_TIMING_PERIOD: 相邻两次 motor_api_run_once 开始时间之差
+ *   - MA_TIMING_SEND_JITTER: 实际发送时刻晚于计划发送时刻的量（仅实时周期线程）
+ */
+typedef enum {
+    MA_TIMING_WAKEUP = 0,
+    MA_TIMING_RECEIVE = 1,
+    MA_TIMING_COMPUTE = 2,
+    MA_TIMING_SEND = 3,
+    MA_TIMING_PERIOD = 4,
+    MA_TIMING_SEND_JITTER = 5,
+    MA_TIMING_PHASES = 6
+} ma_timing_phase_t;
+
+/*
+ * 结构: ma_timing_summary_t
+ * 功能: 单个阶段的耗时统计摘要，单位纳秒。
+ * 说明: 分位数取对数线性直方图中所在桶的上界，相对误差不超过 1/16。
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t mean;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+} ma_timing_summary_t;
+
+/*
+ * 结构: ma_watchdog_config_t
+ * 功能: 看门狗线程配置。
+ * 字段:
+ *   - check_period_us: 检查周期（微秒）
+ *   - stall_timeout_us: 停滞时限（微秒），心跳间隔超过该值视为周期停滞
+ *   - priority: SCHED_FIFO 优先级，应低于周期线程；0 表示使用默认调度策略
+ *   - cpu: 绑定的 CPU 编号，-1 表示不绑定
+ */
+typedef struct {
+    uint32_t check_period_us;
+    uint32_t stall_timeout_us;
+    int priority;
+    int cpu;
+} ma_watchdog_config_t;
+
+/*
+ * 结构: ma_watchdog_stats_t
+ * 功能: 看门狗统计。
+ * 字段:
+ *   - heartbeats: 周期心跳次数
+ *   - stalls: 检测到的停滞次数
+ *   - max_gap_ns: 观察到的最大心跳间隔
+ *   - max_stall_ns: 已恢复停滞的最长时长
+ *   - stalled: 当前是否停滞
+ *   - tripped: 是否已触发受控停机
+ */
+typedef struct {
+    uint64_t heartbeats;
+    uint64_t stalls;
+    uint64_t max_gap_ns;
+    uint64_t max_stall_ns;
+    bool stalled;
+    bool tripped;
+} ma_watchdog_stats_t;
+
+/*
+ * 任务函数类型
+ * 功能: 多速率任务入口，user 为注册时传入的指针，cycle 为当前周期号。
+ */
+typedef void (*ma_task_fn_t)(void *user, uint64_t cycle);
+
+/* 由库选择与已注册任务重叠最少的相位 */
+#define MA_TASK_AUTO_PHASE 0xFFFFFFFFu
+
+/*
+ * 结构: ma_task_info_t
+ * 功能: 任务信息与耗时统计。
+ * 字段:
+ *   - name: 任务名
+ *   - divisor: 分频数，每 divisor 个周期执行一次
+ *   - phase: 相位，在 cycle % divisor == phase 的周期执行
+ *   - runs: 执行次数
+ *   - max_ns: 最大耗时（纳秒）
+ */
+typedef struct {
+    const char *name;
+    uint32_t divisor;
+    uint32_t phase;
+    uint64_t runs;
+    uint64_t max_ns;
+} ma_task_info_t;
+
+/*
+ * 结构: ma_axis_command_t
+ * 功能: 单轴运行命令。
+ * 字段:
+ *   - run: 是否运动
+ *   - dir: 方向（-1 反向，0 停止，1 正向）
+ *   - step: 步长/速度，内部限制范围为 [1, 100000]
+ */
+typedef struct {
+    bool run;
+    int dir;
+    int step;
+} ma_axis_command_t;
+
+/* 快照可容纳的最大轴数 */
+#define MA_SNAPSHOT_MAX_AXES 16
+
+/*
+ * 结构: ma_snapshot_t
+ * 功能: 每个周期发送完成后发布的全轴快照。
+ * 字段:
+ *   - cycle: 周期序号，从 1 开始，每完成一个周期加 1
+ *   - timestamp_ns: 该周期接收开始时间（CLOCK_MONOTONIC 纳秒）
+ *   - axis_count: 有效轴数
+ *   - statusword: 0x6041 状态字
+ *   - error_code: 0x603F 错误码
+ *   - actual_position: 0x6064 实际位置
+ *   - target_position: 本周期发出的 0x607A 目标位置
+ *   - masks: 全轴状态位掩码
+ */
+typedef struct {
+    uint64_t cycle;
+    uint64_t timestamp_ns;
+    uint16_t axis_count;
+    uint16_t statusword[MA_SNAPSHOT_MAX_AXES];
+    uint16_t error_code[MA_SNAPSHOT_MAX_AXES];
+    int32_t actual_position[MA_SNAPSHOT_MAX_AXES];
+    int32_t target_position[MA_SNAPSHOT_MAX_AXES];
+    ma_status_masks_t masks;
+} ma_snapshot_t;
+
 /*
  * 句柄类型前置声明
  * 说明: 所有对外 API 通过不透明句柄管理内部资源，确保线程安全与封装性。
@@ -113,10 +335,10 @@ EXTERNFUNC ma_status_t motor_api_destroy(struct motor_api_handle *handle);
  * 功能: 启动 HTTP 服务线程，提供基本控制与诊断接口。
  * 端点:
  *   - GET /        健康检查
- *   - GET /status  当前运行参数（run/dir/step）
+ *   - GET /status  当前运行参数（run/dir/step）及各轴独立命令（axes）
  *   - GET /diag    诊断信息（状态字/模式/位置等）
- *   - POST /control {direction:"forward|reverse", step:<int>} 运行指令
- *   - POST /stop   停止指令
+ *   - POST /control {direction:"forward|reverse", step:<int>[, axis:<int>]} 运行指令，带 axis 时只作用于该轴
+ *   - POST /stop   停止指令，请求体带 {axis:<int>} 时只停止该轴
  *   - POST /shutdown 关闭 HTTP 服务
  * 参数:
  *   - handle: 库句柄
@@ -146,6 +368,251 @@ EXTERNFUNC ma_status_t motor_api_stop_http(struct motor_api_handle *handle);
  */
 EXTERNFUNC ma_status_t motor_api_run_once(struct motor_api_handle *handle);
 
+/*
+ * 函数: motor_api_start_cyclic
+ * 功能: 创建实时周期线程，以 cycle_us 为周期调用 motor_api_run_once。
+ * 参数:
+ *   - handle: 库句柄
+ *   - rt: 实时配置，可为 NULL（默认调度策略、不绑定 CPU、不锁内存）
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL；MA_ERR_RUNTIME 线程已运行、
+ *     已创建周期定时器（由外部事件循环驱动）或创建失败
+ * 注意事项:
+ *   - 线程按 CLOCK_MONOTONIC 上的绝对截止时间以 clock_nanosleep(TIMER_ABSTIME) 睡眠，
+ *     计算耗时与调度延迟不会累积，周期长期保持锁定
+ *   - 错过截止时间时跳过整周期并保持相位
+ *   - spin_margin_ns 非 0 时先睡眠到截止时间前该提前量，再在 CLOCK_MONOTONIC 上自旋，
+ *     自旋会占满所在 CPU，应配合 cpu 绑定到隔离核
+ *   - send_offset_ns 非 0 时发送固定在周期起点之后该偏移处，计算超时则立即发送
+ *   - pipelined 为 true 时计算在发送之后进行，MA_TIMING_COMPUTE 记录的是为下一帧计算的耗时
+ *   - 超时后的周期按 overrun_policy 降级；受控停机后线程继续收发以维持总线，
+ *     直到 motor_api_stop_cyclic，重新 start 后解除
+ *   - SCHED_FIFO 需要 CAP_SYS_NICE；设置失败时打印警告并以默认策略运行
+ *   - 启动后不要在其他线程再调用 motor_api_run_once
+ * 使用示例:
+ *   ma_rt_config_t rt = { 80, 1, true, 64 * 1024, 50000, 200000, MA_OVERRUN_EXTRAPOLATE, 10, false };  // 250µs 周期
+ *   motor_api_start_cyclic(h, &rt);
+ */
+EXTERNFUNC ma_status_t motor_api_start_cyclic(struct motor_api_handle *handle, const ma_rt_config_t *rt);
+
+/*
+ * 函数: motor_api_stop_cyclic
+ * 功能: 停止实时周期线程并等待退出。
+ * 参数:
+ *   - handle: 库句柄
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL
+ */
+EXTERNFUNC ma_status_t motor_api_stop_cyclic(struct motor_api_handle *handle);
+
+/*
+ * 函数: motor_api_start_watchdog
+ * 功能: 启动带外看门狗线程，监视 motor_api_run_once 每周期发布的心跳。
+ * 参数:
+ *   - handle: 库句柄
+ *   - cfg: 看门狗配置
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL；MA_ERR_RUNTIME 已运行或线程创建失败
+ * 注意事项:
+ *   - 心跳间隔超过 stall_timeout_us 时打印诊断 JSON 并触发受控停机：全轴保位并写 0x0002
+ *   - 周期线程停在总线收发之外时，看门狗每个检查周期自行收发一次快速停止帧；
+ *     周期线程恢复后继续发送快速停止帧，直到重新 motor_api_start_watchdog
+ */
+EXTERNFUNC ma_status_t motor_api_start_watchdog(struct motor_api_handle *handle,
+                                                const ma_watchdog_config_t *cfg);
+
+/*
+ * 函数: motor_api_stop_watchdog
+ * 功能: 停止看门狗线程并等待退出。
+ * 参数:
+ *   - handle: 库句柄
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL
+ */
+EXTERNFUNC ma_status_t motor_api_stop_watchdog(struct motor_api_handle *handle);
+
+/*
+ * 函数: motor_api_get_watchdog_stats
+ * 功能: 获取看门狗统计。
+ * 参数:
+ *   - handle: 库句柄
+ *   - out_stats: 输出统计
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL
+ */
+EXTERNFUNC ma_status_t motor_api_get_watchdog_stats(struct motor_api_handle *handle,
+                                                    ma_watchdog_stats_t *out_stats);
+
+/*
+ * 函数: motor_api_add_task
+ * 功能: 注册多速率任务，在每个周期发送完成后按分频与相位执行。
+ * 参数:
+ *   - handle: 库句柄
+ *   - name: 任务名（需在句柄生命周期内有效）
+ *   - divisor: 分频数，0 按 1 处理；按时间间隔换算为 间隔 / cycle_us
+ *   - phase: 相位，MA_TASK_AUTO_PHASE 表示自动选择
+ *   - fn: 任务函数
+ *   - user: 传给任务函数的指针
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL；MA_ERR_RUNTIME 任务表已满或周期线程正在运行
+ * 注意事项:
+ *   - 库内置域状态（每周期）、主站状态（每 10 周期）、从站状态（每 100 周期）三项任务
+ *   - 自动相位使慢任务分散到不同周期，单周期最坏耗时为一个时隙内任务之和
+ *   - 任务在周期线程中执行，不应阻塞
+ */
+EXTERNFUNC ma_status_t motor_api_add_task(struct motor_api_handle *handle,
+                                          const char *name,
+                                          uint32_t divisor,
+                                          uint32_t phase,
+                                          ma_task_fn_t fn,
+                                          void *user);
+
+/*
+ * 函数: motor_api_get_task_info
+ * 功能: 获取任务信息与耗时统计。
+ * 参数:
+ *   - handle: 库句柄
+ *   - index: 任务索引（内置任务在前）
+ *   - out_info: 输出信息
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL 或索引越界
+ */
+EXTERNFUNC ma_status_t motor_api_get_task_info(struct motor_api_handle *handle,
+                                               uint16_t index,
+                                               ma_task_info_t *out_info);
+
+/*
+ * 函数: motor_api_get_overruns
+ * 功能: 获取实时周期线程的超时统计与受控停机状态。
+ * 参数:
+ *   - handle: 库句柄
+ *   - out_overruns: 输出超时周期数，可为 NULL
+ *   - out_tripped: 输出是否已因连续超时受控停机，可为 NULL
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL
+ */
+EXTERNFUNC ma_status_t motor_api_get_overruns(struct motor_api_handle *handle,
+                                              uint64_t *out_overruns,
+                                              bool *out_tripped);
+
+/*
+ * 函数: motor_api_get_status_masks
+ * 功能: 获取最近一次周期计算的全轴状态位掩码。
+ * 参数:
+ *   - handle: 库句柄
+ *   - out_masks: 输出掩码
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL
+ * 注意事项:
+ *   - 仅做拷贝，应与 motor_api_run_once 在同一线程调用
+ */
+EXTERNFUNC ma_status_t motor_api_get_status_masks(struct motor_api_handle *handle,
+                                                  ma_status_masks_t *out_masks);
+
+/*
+ * 函数: motor_api_open_timer_fd
+ * 功能: 创建以 cycle_us 为周期、按绝对截止时间到期的非阻塞 timerfd，供外部事件循环驱动周期。
+ * 参数:
+ *   - handle: 库句柄
+ *   - out_fd: 输出描述符，可读时调用 motor_api_dispatch_timer
+ * 返回:
+ *   - MA_OK 成功（已创建时返回同一描述符）；MA_ERR_PARAM 当参数为 NULL；
+ *     MA_ERR_RUNTIME 实时周期线程正在运行或创建失败
+ * 注意事项:
+ *   - 描述符归库所有，由 motor_api_close_event_fds 或 motor_api_destroy 关闭
+ * 使用示例:
+ *   int tfd; motor_api_open_timer_fd(h, &tfd);
+ *   // 将 tfd 以 EPOLLIN 加入 epoll；可读时：
+ *   motor_api_dispatch_timer(h, NULL);
+ */
+EXTERNFUNC ma_status_t motor_api_open_timer_fd(struct motor_api_handle *handle, int *out_fd);
+
+/*
+ * 函数: motor_api_dispatch_timer
+ * 功能: 非阻塞读取周期定时器，已到期时执行一次周期控制（同 motor_api_run_once）。
+ * 参数:
+ *   - handle: 库句柄
+ *   - out_expirations: 输出本次读到的到期次数，0 表示尚未到期（未执行周期），可为 NULL
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL；MA_ERR_RUNTIME 定时器尚未创建
+ * 注意事项:
+ *   - 到期次数大于 1 表示事件循环处理不及时，错过的周期直接跳过，计入 motor_api_get_overruns
+ *   - 截止时间到实际处理的延迟计入 MA_TIMING_WAKEUP
+ */
+EXTERNFUNC ma_status_t motor_api_dispatch_timer(struct motor_api_handle *handle, uint64_t *out_expirations);
+
+/*
+ * 函数: motor_api_open_cycle_fd
+ * 功能: 创建周期完成通知 eventfd，每个周期发送完成并发布快照后计数加 1。
+ * 参数:
+ *   - handle: 库句柄
+ *   - out_fd: 输出描述符，可读表示有新周期完成
+ * 返回:
+ *   - MA_OK 成功（已创建时返回同一描述符）；MA_ERR_PARAM 当参数为 NULL；MA_ERR_RUNTIME 创建失败
+ * 注意事项:
+ *   - 实时周期线程、motor_api_dispatch_timer、motor_api_run_once 驱动的周期都会通知
+ *   - 消费方 read 8 字节清零计数后用 motor_api_poll_snapshot 读取快照
+ *   - 应在启动周期之前创建
+ */
+EXTERNFUNC ma_status_t motor_api_open_cycle_fd(struct motor_api_handle *handle, int *out_fd);
+
+/*
+ * 函数: motor_api_close_event_fds
+ * 功能: 关闭周期定时器与周期完成通知描述符。
+ * 参数:
+ *   - handle: 库句柄
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL
+ * 注意事项:
+ *   - 不应在周期运行时调用
+ */
+EXTERNFUNC ma_status_t motor_api_close_event_fds(struct motor_api_handle *handle);
+
+/*
+ * 函数: motor_api_poll_snapshot
+ * 功能: 非阻塞读取最近一个周期发布的快照。
+ * 参数:
+ *   - handle: 库句柄
+ *   - last_cycle: 调用方上次读到的周期序号，首次传 0
+ *   - out_snapshot: 输出快照，仅在有新快照时写入
+ *   - out_fresh: 输出是否读到了比 last_cycle 新的快照
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL
+ * 注意事项:
+ *   - 快照以序列锁发布，可在任意线程调用；周期线程从不等待读者，
+ *     读到正在写入的快照时读者重试
+ */
+EXTERNFUNC ma_status_t motor_api_poll_snapshot(struct motor_api_handle *handle,
+                                               uint64_t last_cycle,
+                                               ma_snapshot_t *out_snapshot,
+                                               bool *out_fresh);
+
+/*
+ * 函数: motor_api_get_timing
+ * 功能: 获取指定周期阶段的耗时统计摘要。
+ * 参数:
+ *   - handle: 库句柄
+ *   - phase: 周期阶段
+ *   - out_summary: 输出摘要
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL 或 phase 越界
+ * 注意事项:
+ *   - 统计在 motor_api_run_once 中常开，记录无锁，可在任意线程查询
+ */
+EXTERNFUNC ma_status_t motor_api_get_timing(struct motor_api_handle *handle,
+                                            ma_timing_phase_t phase,
+                                            ma_timing_summary_t *out_summary);
+
+/*
+ * 函数: motor_api_reset_timing
+ * 功能: 清空全部阶段的耗时统计。
+ * 参数:
+ *   - handle: 库句柄
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL
+ */
+EXTERNFUNC ma_status_t motor_api_reset_timing(struct motor_api_handle *handle);
+
 /*
  * 函数: motor_api_set_command
  * 功能: 设置运行指令（CSP 的目标增量或 CSV 的目标速度）。
@@ -156,12 +623,47 @@ EXTERNFUNC ma_status_t motor_api_run_once(struct motor_api_handle *handle);
  *   - step: 步长/速度，内部限制范围为 [1, 100000]
  * 注意事项:
  *   - 栅栏触发前（同步起动），库会“保位”而不推进目标
+ *   - 作用于未设置独立命令的轴
+ *   - 可在任意线程调用；命令以三缓冲发布，周期线程每周期无锁读取一次，
+ *     从不等待调用方，周期最坏延迟与 HTTP 等命令来源的负载无关
  */
 EXTERNFUNC ma_status_t motor_api_set_command(struct motor_api_handle *handle,
                                              bool run,
                                              int dir,
                                              int step);
 
+/*
+ * 函数: motor_api_set_axis_commands
+ * 功能: 设置若干轴的独立运行命令，这些轴不再跟随全局命令。
+ * 参数:
+ *   - handle: 库句柄
+ *   - axis_mask: 要设置的轴位掩码
+ *   - cmds: 按轴索引排列的命令数组，只读取 axis_mask 中的轴
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数为 NULL 或掩码含不存在的轴
+ * 注意事项:
+ *   - 同一次调用设置的各轴命令在同一周期生效
+ *   - 线程安全要求同 motor_api_set_command
+ * 使用示例:
+ *   ma_axis_command_t cmds[2] = { { true, 1, 500 }, { true, -1, 200 } };
+ *   motor_api_set_axis_commands(h, 0x3, cmds);
+ */
+EXTERNFUNC ma_status_t motor_api_set_axis_commands(struct motor_api_handle *handle,
+                                                   uint32_t axis_mask,
+                                                   const ma_axis_command_t *cmds);
+
+/*
+ * 函数: motor_api_clear_axis_commands
+ * 功能: 撤销若干轴的独立命令，恢复跟随全局命令。
+ * 参数:
+ *   - handle: 库句柄
+ *   - axis_mask: 要撤销的轴位掩码
+ * 返回:
+ *   - MA_OK 成功；MA_ERR_PARAM 当 handle 为 NULL
+ */
+EXTERNFUNC ma_status_t motor_api_clear_axis_commands(struct motor_api_handle *handle,
+                                                     uint32_t axis_mask);
+
 /*
  * 函数: motor_api_read_eni
  * 功能: 读取 ENI XML，解析从站 VendorId/ProductCode/Position 等常见属性。
@@ -192,7 +694,9 @@ EXTERNFUNC ma_status_t motor_api_read_eni(const char *eni_path,
  *   - buf: 输出缓冲区
  *   - buf_size: 缓冲区长度（字节）
  * 返回:
- *   - MA_OK 成功；MA_ERR_PARAM 当参数非法；MA_ERR_RUNTIME 当格式化失败
+ *   - MA_OK 成功；MA_ERR_PARAM 当参数非法；MA_ERR_RUNTIME 当格式化失败或缓冲区不足
+ * 注意事项:
+ *   - 末尾 "timing" 对象给出各周期阶段的耗时统计（纳秒），建议缓冲区不小于 2048 字节
  */
 EXTERNFUNC ma_status_t motor_api_format_diag_json(struct motor_api_handle *handle,
                                                   char *buf,
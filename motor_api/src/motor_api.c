@@ -8,8 +8,20 @@
  * 修改历史:
  *   - 2025-11-28: 初始实现，支持 ENI 读取、PDO 注册、DC 配置、HTTP 服务。
  *   - 2025-11-28: 增加“全轴使能(0x27)后延时 1s 同步起动”的栅栏机制与调试输出。
+ *   - 2026-10-15: 状态字每周期压缩为全轴位掩码（SSE2 并行比较），栅栏改用掩码判断。
+ *   - 2026-10-15: 增加实时周期线程（绝对截止时间、SCHED_FIFO、CPU 亲和性、mlockall、栈预触碰）。
+ *   - 2026-10-15: 增加周期各阶段耗时的无锁对数线性直方图，诊断 JSON 附带耗时统计。
+ *   - 2026-10-15: 周期线程支持睡眠+自旋混合等待与固定发送偏移，统计发送抖动。
+ *   - 2026-10-15: 周期线程检测超时并按策略降级（重发/保位/外推），连续超时受控停机。
+ *   - 2026-10-15: 增加带外看门狗线程：监视周期心跳，停滞时接管总线发送快速停止并输出诊断。
+ *   - 2026-10-15: 增加多速率任务表，域/主站/从站状态检查改为按分频错相执行。
+ *   - 2026-10-15: 增加周期定时器 timerfd 与周期完成 eventfd，快照以序列锁每周期发布。
+ *   - 2026-10-15: 运行命令改为三缓冲命令块，周期线程每周期无锁读取一次；增加按轴命令。
+ *   - 2026-10-16: 看门狗停滞诊断只输出心跳与耗时统计等原子数据，不再读取周期线程可能正在写入的域数据。
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,18 +30,40 @@
 #include <stdbool.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <limits.h>
 #include <time.h>
 #include <pthread.h>
+#include <sched.h>
 #include <signal.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "motor_api.h"
 #include "ecrt.h"
 
 #define MA_MAX_SLAVES 16
 #define MA_MAX_DELTA_PER_CYCLE 400000
+#define MA_MAX_TASKS 16
+
+/* 命令块三缓冲交换槽的“有新命令”标志位 */
+#define MA_CMD_FRESH 0x4
+
+/* 快照按库内最大轴数定长 */
+typedef char ma_snapshot_axes_check[MA_SNAPSHOT_MAX_AXES >= MA_MAX_SLAVES ? 1 : -1];
+
+/* 耗时直方图：每个 2 的幂区间等分为 16 个子桶，覆盖 1ns 到 2^41ns */
+#define MA_HIST_SUB_BITS 4
+#define MA_HIST_SUB_BUCKETS (1u << MA_HIST_SUB_BITS)
+#define MA_HIST_MAX_EXP 40
+#define MA_HIST_BUCKETS ((MA_HIST_MAX_EXP - MA_HIST_SUB_BITS + 2) * MA_HIST_SUB_BUCKETS)
 
 /*
  * 结构: ma_output_offsets_t
@@ -73,6 +107,50 @@ typedef struct {
     unsigned int servoErrorCode;
 } ma_input_offsets_t;
 
+/*
+ * 结构: ma_histogram_t
+ * 功能: 无锁对数线性耗时直方图，周期线程写入，其他线程可随时读取。
+ * 字段:
+ *   - counts: 各桶计数
+ *   - count/sum: 样本数与样本和
+ *   - min/max: 最小/最大值，min 无样本时为 UINT64_MAX
+ */
+typedef struct {
+    uint64_t counts[MA_HIST_BUCKETS];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+} ma_histogram_t;
+
+/*
+ * 结构: ma_task_t
+ * 功能: 多速率任务表项，在 cycle % divisor == phase 的周期执行。
+ */
+typedef struct {
+    const char *name;
+    uint32_t divisor;
+    uint32_t phase;
+    ma_task_fn_t fn;
+    void *user;
+    uint64_t runs;
+    uint64_t max_ns;
+} ma_task_t;
+
+/*
+ * 结构: ma_command_block_t
+ * 功能: 周期线程每周期读取一次的完整命令：全局命令与各轴独立命令。
+ * 字段:
+ *   - global: 全局命令，未设置独立命令的轴跟随
+ *   - axis: 各轴独立命令
+ *   - axis_override: 使用独立命令的轴位掩码
+ */
+typedef struct {
+    ma_axis_command_t global;
+    ma_axis_command_t axis[MA_MAX_SLAVES];
+    uint32_t axis_override;
+} ma_command_block_t;
+
 /*
  * 结构: motor_api_handle
  * 功能: 库内部句柄，封装主站/域/从站配置、周期控制状态、命令与调试信息。
@@ -101,23 +179,71 @@ typedef struct motor_api_handle {
     int http_port;
     volatile sig_atomic_t stop;
 
-    pthread_mutex_t cmd_mutex; /* 命令互斥，保护 run/dir/step */
-    bool cmd_run;              /* 运行标志 */
-    int cmd_dir;               /* 方向：-1/0/1 */
-    int cmd_step;              /* 步长/速度（内部限制范围） */
+    pthread_mutex_t cmd_mutex;              /* 命令写者互斥，只在非实时线程之间串行化写入，周期线程从不获取 */
+    ma_command_block_t cmd;                 /* 写者侧的当前命令（cmd_mutex 保护） */
+    ma_command_block_t cmd_slots[3];        /* 命令三缓冲：写者与周期线程各占一槽，第三槽用于交换 */
+    int cmd_back;                           /* 写者占用的槽（cmd_mutex 保护） */
+    int cmd_middle;                         /* 交换槽下标，MA_CMD_FRESH 表示有未读取的新命令（原子访问） */
+    int cmd_front;                          /* 周期线程占用的槽 */
 
     int32_t last_actual_pos[MA_MAX_SLAVES]; /* 上次实际位置快照 */
     uint32_t time_cnt[MA_MAX_SLAVES];       /* 轴内时间计数（调试/预热） */
     bool servo_enabled[MA_MAX_SLAVES];      /* 轴使能标志（到达 0x27 后置位） */
     int csp_warmup[MA_MAX_SLAVES];          /* CSP 预热计数，避免首次跳变 */
     int32_t csp_target[MA_MAX_SLAVES];      /* CSP 目标位置 */
-    bool seen_enabled[MA_MAX_SLAVES];       /* 观察到 0x27（enabled） */
+    int32_t csp_delta[MA_MAX_SLAVES];       /* 上一周期的目标增量（超时外推用） */
+    ma_status_masks_t masks;                /* 本周期全轴状态位掩码 */
+    uint32_t seen_enabled;                  /* 曾观察到 0x27（enabled）的从站位掩码 */
     int barrier_armed;                      /* 延迟栅栏已武装 */
     uint64_t barrier_start_ns;              /* 延迟起始时间 */
     uint64_t barrier_delay_ns;              /* 延迟时长（ns） */
     int motion_started;                     /* 延迟结束后开始运动 */
+
+    pthread_t cyclic_thread;                /* 实时周期线程 */
+    int cyclic_running;                     /* 周期线程已启动 */
+    volatile sig_atomic_t cyclic_stop;      /* 周期线程停止请求 */
+    ma_rt_config_t rt;                      /* 实时配置 */
+    uint64_t cyclic_cycles;                 /* 已执行周期数 */
+    uint64_t cyclic_missed;                 /* 跳过的截止时间数 */
+    uint64_t cyclic_overruns;               /* 超时周期数 */
+    uint32_t cyclic_consecutive;            /* 连续超时周期数 */
+    volatile int overrun_tripped;           /* 连续超时已触发受控停机 */
+    uint16_t pipe_control[MA_MAX_SLAVES];   /* 流水线模式暂存的下一帧控制字 */
+    int8_t pipe_mode[MA_MAX_SLAVES];        /* 流水线模式暂存的下一帧操作模式 */
+    int32_t pipe_target[MA_MAX_SLAVES];     /* 流水线模式暂存的下一帧目标位置 */
+    int pipe_staged;                        /* 暂存区有效 */
+
+    int bus_owner;                          /* 总线收发占用者：0 空闲，1 周期，2 看门狗（原子访问） */
+    uint64_t heartbeat_ns;                  /* 最近一次周期发送完成时间（原子访问） */
+    uint64_t heartbeats;                    /* 心跳次数（原子访问） */
+    pthread_t wd_thread;                    /* 看门狗线程 */
+    int wd_running;                         /* 看门狗线程已启动 */
+    volatile sig_atomic_t wd_stop;          /* 看门狗停止请求 */
+    ma_watchdog_config_t wd;                /* 看门狗配置 */
+    int wd_stalled;                         /* 当前停滞（原子访问） */
+    int wd_tripped;                         /* 看门狗已触发受控停机（原子访问） */
+    uint64_t wd_stalls;                     /* 检测到的停滞次数 */
+    uint64_t wd_max_gap_ns;                 /* 最大心跳间隔 */
+    ma_histogram_t wd_stall_hist;           /* 已恢复停滞的时长分布 */
+
+    ma_task_t tasks[MA_MAX_TASKS];          /* 多速率任务表 */
+    uint16_t task_count;                    /* 任务数 */
+    uint64_t cycle_no;                      /* 周期号（任务调度用） */
+
+    ma_histogram_t timing[MA_TIMING_PHASES]; /* 各周期阶段耗时直方图 */
+    uint64_t last_cycle_start_ns;           /* 上次 run_once 开始时间，0 表示尚无 */
+
+    int timer_fd;                           /* 外部事件循环的周期定时器，-1 表示未创建 */
+    uint64_t timer_start_ns;                /* 定时器启动时间，第 k 次到期为 start + k * 周期 */
+    uint64_t timer_expirations;             /* 定时器累计到期次数 */
+    int cycle_fd;                           /* 周期完成通知 eventfd，-1 表示未创建 */
+    uint32_t snap_seq;                      /* 快照序列锁，奇数表示正在写入（原子访问） */
+    ma_snapshot_t snap;                     /* 每周期发布的快照 */
 } motor_api_handle_t;
 
+static void run_cycle(motor_api_handle_t *h, uint64_t send_at, ma_overrun_policy_t degrade, bool pipelined);
+static void quick_stop_outputs(motor_api_handle_t *h);
+
 /*
  * 函数: monotonic_ns
  * 功能: 获取单调时钟当前时间（纳秒），用于 DC 同步与延时栅栏计时。
@@ -128,16 +254,187 @@ static uint64_t monotonic_ns(void) {
 }
 
 /*
- * 函数: set_cmd_locked
- * 功能: 在互斥保护下更新运行命令，限制参数合法范围。
+ * 函数: hist_index
+ * 功能: 计算样本所在的直方图桶，小于 16 的值精确计数，超出范围计入最后一个桶。
  */
-static void set_cmd_locked(motor_api_handle_t *h, bool run, int dir, int step) {
-    if (!h) return;
+static unsigned hist_index(uint64_t v) {
+    if (v < MA_HIST_SUB_BUCKETS) return (unsigned)v;
+    unsigned e = 63u - (unsigned)__builtin_clzll(v);
+    if (e > MA_HIST_MAX_EXP) return MA_HIST_BUCKETS - 1;
+    unsigned sub = (unsigned)(v >> (e - MA_HIST_SUB_BITS)) & (MA_HIST_SUB_BUCKETS - 1);
+    return (e - MA_HIST_SUB_BITS + 1) * MA_HIST_SUB_BUCKETS + sub;
+}
+
+/*
+ * 函数: hist_upper
+ * 功能: 计算直方图桶的上界（包含）。
+ */
+static uint64_t hist_upper(unsigned idx) {
+    if (idx < MA_HIST_SUB_BUCKETS) return idx;
+    unsigned e = idx / MA_HIST_SUB_BUCKETS + MA_HIST_SUB_BITS - 1;
+    uint64_t sub = idx % MA_HIST_SUB_BUCKETS;
+    return ((MA_HIST_SUB_BUCKETS + sub) << (e - MA_HIST_SUB_BITS)) + (1ULL << (e - MA_HIST_SUB_BITS)) - 1;
+}
+
+/*
+ * 函数: hist_reset
+ * 功能: 清空直方图。
+ */
+static void hist_reset(ma_histogram_t *hg) {
+    for (unsigned i = 0; i < MA_HIST_BUCKETS; ++i) __atomic_store_n(&hg->counts[i], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&hg->count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&hg->sum, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&hg->min, UINT64_MAX, __ATOMIC_RELAXED);
+    __atomic_store_n(&hg->max, 0, __ATOMIC_RELAXED);
+}
+
+/*
+ * 函数: hist_record
+ * 功能: 记录一个样本（纳秒），只用无锁原子操作，可在周期内常开。
+ */
+static void hist_record(ma_histogram_t *hg, uint64_t v) {
+    __atomic_fetch_add(&hg->counts[hist_index(v)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hg->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hg->sum, v, __ATOMIC_RELAXED);
+    uint64_t cur = __atomic_load_n(&hg->min, __ATOMIC_RELAXED);
+    while (v < cur && !__atomic_compare_exchange_n(&hg->min, &cur, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) { }
+    cur = __atomic_load_n(&hg->max, __ATOMIC_RELAXED);
+    while (v > cur && !__atomic_compare_exchange_n(&hg->max, &cur, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) { }
+}
+
+/*
+ * 函数: hist_percentile
+ * 功能: 按桶计数求分位数，返回所在桶上界且不超过最大值。
+ */
+static uint64_t hist_percentile(const ma_histogram_t *hg, double percent) {
+    uint64_t total = 0;
+    for (unsigned i = 0; i < MA_HIST_BUCKETS; ++i) total += __atomic_load_n(&hg->counts[i], __ATOMIC_RELAXED);
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)(percent / 100.0 * (double)total + 0.5);
+    if (rank == 0) rank = 1;
+    if (rank > total) rank = total;
+    uint64_t hi = __atomic_load_n(&hg->max, __ATOMIC_RELAXED), seen = 0;
+    for (unsigned i = 0; i < MA_HIST_BUCKETS; ++i) {
+        seen += __atomic_load_n(&hg->counts[i], __ATOMIC_RELAXED);
+        if (seen >= rank) { uint64_t up = hist_upper(i); return up < hi ? up : hi; }
+    }
+    return hi;
+}
+
+/*
+ * 函数: hist_summary
+ * 功能: 生成直方图摘要。
+ */
+static void hist_summary(const ma_histogram_t *hg, ma_timing_summary_t *out) {
+    out->count = __atomic_load_n(&hg->count, __ATOMIC_RELAXED);
+    uint64_t mn = __atomic_load_n(&hg->min, __ATOMIC_RELAXED);
+    out->min = mn == UINT64_MAX ? 0 : mn;
+    out->max = __atomic_load_n(&hg->max, __ATOMIC_RELAXED);
+    out->mean = out->count ? __atomic_load_n(&hg->sum, __ATOMIC_RELAXED) / out->count : 0;
+    out->p50 = hist_percentile(hg, 50.0);
+    out->p90 = hist_percentile(hg, 90.0);
+    out->p99 = hist_percentile(hg, 99.0);
+    out->p999 = hist_percentile(hg, 99.9);
+}
+
+/*
+ * 函数: match_status
+ * 功能: 计算 (sw[i] & mask) == value 的位掩码，第 i 位对应第 i 个状态字。
+ * 说明: 支持 SSE2 时 16 个状态字（MA_MAX_SLAVES）一次并行比较，否则逐个比较。
+ */
+static uint32_t match_status(const uint16_t *sw, uint16_t count, uint16_t mask, uint16_t value) {
+#if defined(__SSE2__) && MA_MAX_SLAVES == 16
+    const __m128i vmask = _mm_set1_epi16((short)mask);
+    const __m128i vvalue = _mm_set1_epi16((short)value);
+    __m128i lo = _mm_loadu_si128((const __m128i *)sw);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(sw + 8));
+    lo = _mm_cmpeq_epi16(_mm_and_si128(lo, vmask), vvalue);
+    hi = _mm_cmpeq_epi16(_mm_and_si128(hi, vmask), vvalue);
+    uint32_t bits = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(lo, hi));
+    return count >= 32 ? bits : bits & ((1u << count) - 1u);
+#else
+    uint32_t bits = 0;
+    for (uint16_t i = 0; i < count; ++i) bits |= (uint32_t)((sw[i] & mask) == value) << i;
+    return bits;
+#endif
+}
+
+/*
+ * 函数: update_status_masks
+ * 功能: 由全轴状态字（长度 MA_MAX_SLAVES，未用部分为 0）计算本周期状态位掩码。
+ */
+static void update_status_masks(motor_api_handle_t *h, const uint16_t *sw) {
+    uint16_t n = h->slave_count;
+    h->masks.axes = n >= 32 ? 0xFFFFFFFFu : ((1u << n) - 1u);
+    h->masks.enabled = match_status(sw, n, 0x006F, 0x0027);
+    h->masks.fault = match_status(sw, n, 0x0008, 0x0008);
+    h->masks.warning = match_status(sw, n, 0x0080, 0x0080);
+    h->masks.target_reached = match_status(sw, n, 0x0400, 0x0400);
+    h->masks.following_error = match_status(sw, n, 0x2000, 0x2000);
+    h->masks.quick_stop = match_status(sw, n, 0x006F, 0x0007);
+    h->seen_enabled |= h->masks.enabled;
+}
+
+/*
+ * 函数: clamp_command
+ * 功能: 限制命令参数的合法范围。
+ */
+static ma_axis_command_t clamp_command(bool run, int dir, int step) {
+    ma_axis_command_t c;
     if (step < 1) step = 1;
     if (step > 100000) step = 100000;
     if (dir != -1 && dir != 0 && dir != 1) dir = 0;
+    c.run = run; c.dir = dir; c.step = step;
+    return c;
+}
+
+/*
+ * 函数: publish_cmd_locked
+ * 功能: 将写者侧的当前命令拷入写者槽，并与交换槽互换发布（调用方持有 cmd_mutex）。
+ * 说明: 只有一次原子交换，写者不等待周期线程，周期线程也从不等待写者。
+ */
+static void publish_cmd_locked(motor_api_handle_t *h) {
+    h->cmd_slots[h->cmd_back] = h->cmd;
+    int prev = __atomic_exchange_n(&h->cmd_middle, h->cmd_back | MA_CMD_FRESH, __ATOMIC_ACQ_REL);
+    h->cmd_back = prev & ~MA_CMD_FRESH;
+}
+
+/*
+ * 函数: acquire_cmd
+ * 功能: 周期线程取得最新发布的命令块；没有新命令时继续使用上次的命令块。
+ * 说明: 无锁、无等待，每周期调用一次；返回的命令块在下次调用前不会被写者改写。
+ */
+static const ma_command_block_t *acquire_cmd(motor_api_handle_t *h) {
+    if (__atomic_load_n(&h->cmd_middle, __ATOMIC_RELAXED) & MA_CMD_FRESH) {
+        int prev = __atomic_exchange_n(&h->cmd_middle, h->cmd_front, __ATOMIC_ACQ_REL);
+        h->cmd_front = prev & ~MA_CMD_FRESH;
+    }
+    return &h->cmd_slots[h->cmd_front];
+}
+
+/*
+ * 函数: set_global_cmd
+ * 功能: 更新全局运行命令并发布。
+ */
+static void set_global_cmd(motor_api_handle_t *h, bool run, int dir, int step) {
+    if (!h) return;
+    ma_axis_command_t c = clamp_command(run, dir, step);
     pthread_mutex_lock(&h->cmd_mutex);
-    h->cmd_run = run; h->cmd_dir = dir; h->cmd_step = step;
+    h->cmd.global = c;
+    publish_cmd_locked(h);
+    pthread_mutex_unlock(&h->cmd_mutex);
+}
+
+/*
+ * 函数: set_axis_cmd
+ * 功能: 更新单轴独立命令并发布。
+ */
+static void set_axis_cmd(motor_api_handle_t *h, uint16_t axis, bool run, int dir, int step) {
+    ma_axis_command_t c = clamp_command(run, dir, step);
+    pthread_mutex_lock(&h->cmd_mutex);
+    h->cmd.axis[axis] = c;
+    h->cmd.axis_override |= 1u << axis;
+    publish_cmd_locked(h);
     pthread_mutex_unlock(&h->cmd_mutex);
 }
 
@@ -187,6 +484,42 @@ static int parse_control_json(const char *body, int *out_dir, int *out_step) {
     *out_dir = dir; *out_step = (int)step; return 0;
 }
 
+/*
+ * 函数: parse_axis_json
+ * 功能: 解析请求体中可选的 "axis" 字段。
+ * 返回: 轴索引；缺省返回 -1；越界返回 -2。
+ */
+static int parse_axis_json(const motor_api_handle_t *h, const char *body) {
+    if (!body) return -1;
+    const char *akey = strstr(body, "\"axis\""); if (!akey) return -1;
+    const char *acolon = strchr(akey, ':'); if (!acolon) return -2;
+    char *end = NULL; long axis = strtol(acolon + 1, &end, 10);
+    if (end == acolon + 1 || axis < 0 || axis >= (long)h->slave_count) return -2;
+    return (int)axis;
+}
+
+/*
+ * 函数: append_timing
+ * 功能: 在 buf 的 pos 处追加 ,"timing":{...} 各阶段耗时统计（直方图只做原子读取）。
+ * 返回: 追加后的长度；缓冲区不足时返回 0
+ */
+static size_t append_timing(motor_api_handle_t *h, char *buf, size_t buf_size, size_t pos) {
+    static const char *const phase_names[MA_TIMING_PHASES] = { "wakeup", "receive", "compute", "send", "period", "send_jitter" };
+    for (int p = 0; p < MA_TIMING_PHASES; ++p) {
+        ma_timing_summary_t t; hist_summary(&h->timing[p], &t);
+        int n = snprintf(buf + pos, buf_size - pos,
+                         "%s\"%s\":{\"count\":%llu,\"min\":%llu,\"max\":%llu,\"mean\":%llu,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu}",
+                         p == 0 ? ",\"timing\":{" : ",", phase_names[p],
+                         (unsigned long long)t.count, (unsigned long long)t.min, (unsigned long long)t.max, (unsigned long long)t.mean,
+                         (unsigned long long)t.p50, (unsigned long long)t.p90, (unsigned long long)t.p99, (unsigned long long)t.p999);
+        if (n < 0 || (size_t)n >= buf_size - pos) return 0;
+        pos += (size_t)n;
+    }
+    int n = snprintf(buf + pos, buf_size - pos, "}");
+    if (n < 0 || (size_t)n >= buf_size - pos) return 0;
+    return pos + (size_t)n;
+}
+
 /*
  * 函数: format_diag
  * 功能: 汇总各轴关键诊断数据并生成 JSON 字符串。
@@ -211,9 +544,30 @@ static ma_status_t format_diag(motor_api_handle_t *h, char *buf, size_t buf_size
     int n = snprintf(buf, buf_size,
                      "{\"status\":[%u,%u,%u],\"mode\":[%d,%d,%d],\"followingErr\":[%d,%d,%d],\"err\":[%u,%u,%u],\"servoErr\":[%u,%u,%u],\"din\":[%u,%u,%u],\"tpst\":[%u,%u,%u],\"tpp\":[%d,%d,%d],\"tgt\":[%d,%d,%d],\"act\":[%d,%d,%d]}",
                      sw[0], sw[1], sw[2], md[0], md[1], md[2], fe[0], fe[1], fe[2], ec[0], ec[1], ec[2], sec[0], sec[1], sec[2], di[0], di[1], di[2], tpst[0], tpst[1], tpst[2], tpp[0], tpp[1], tpp[2], tgt[0], tgt[1], tgt[2], act[0], act[1], act[2]);
-    if (n < 0) {
+    if (n < 0 || (size_t)n >= buf_size) {
         return MA_ERR_RUNTIME;
     }
+    /* 去掉末尾的 '}'，追加各阶段耗时统计 */
+    size_t pos = append_timing(h, buf, buf_size, (size_t)n - 1);
+    if (!pos) return MA_ERR_RUNTIME;
+    n = snprintf(buf + pos, buf_size - pos, "}");
+    if (n < 0 || (size_t)n >= buf_size - pos) return MA_ERR_RUNTIME;
+    return MA_OK;
+}
+
+/*
+ * 函数: format_timing_diag
+ * 功能: 生成只含心跳次数与各阶段耗时统计的 JSON 字符串。只读原子计数，
+ *       看门狗线程可在周期线程停滞时调用；format_diag 读取的域数据仍可能被周期线程写入。
+ */
+static ma_status_t format_timing_diag(motor_api_handle_t *h, char *buf, size_t buf_size) {
+    if (!h || !buf || buf_size < 64) return MA_ERR_PARAM;
+    int n = snprintf(buf, buf_size, "{\"heartbeats\":%llu", (unsigned long long)__atomic_load_n(&h->heartbeats, __ATOMIC_RELAXED));
+    if (n < 0 || (size_t)n >= buf_size) return MA_ERR_RUNTIME;
+    size_t pos = append_timing(h, buf, buf_size, (size_t)n);
+    if (!pos) return MA_ERR_RUNTIME;
+    n = snprintf(buf + pos, buf_size - pos, "}");
+    if (n < 0 || (size_t)n >= buf_size - pos) return MA_ERR_RUNTIME;
     return MA_OK;
 }
 
@@ -233,15 +587,36 @@ static void *http_thread_fn(void *arg) {
             const char *path = buf + 4; const char *sp = strchr(path, ' '); size_t plen = sp ? (size_t)(sp - path) : 0;
             if (plen == 1 && path[0] == '/') { http_send(cfd, "200 OK", "text/plain", "motor_api running"); close(cfd); continue; }
             if (plen && strncmp(path, "/status", plen) == 0) {
-                char out[256]; pthread_mutex_lock(&h->cmd_mutex); bool run = h->cmd_run; int dir = h->cmd_dir; int step = h->cmd_step; pthread_mutex_unlock(&h->cmd_mutex);
-                int m = snprintf(out, sizeof(out), "{\"run\":%s,\"dir\":%d,\"step\":%d}", run?"true":"false", dir, step); (void)m; http_send(cfd, "200 OK", "application/json", out); close(cfd); continue;
+                char out[1024]; pthread_mutex_lock(&h->cmd_mutex); ma_command_block_t cmd = h->cmd; pthread_mutex_unlock(&h->cmd_mutex);
+                int m = snprintf(out, sizeof(out), "{\"run\":%s,\"dir\":%d,\"step\":%d,\"axes\":[", cmd.global.run?"true":"false", cmd.global.dir, cmd.global.step);
+                const char *sep = "";
+                for (uint16_t i = 0; i < h->slave_count && m > 0 && (size_t)m < sizeof(out); ++i) {
+                    if (!(cmd.axis_override & (1u << i))) continue;
+                    m += snprintf(out + m, sizeof(out) - (size_t)m, "%s{\"axis\":%u,\"run\":%s,\"dir\":%d,\"step\":%d}", sep, (unsigned)i,
+                                  cmd.axis[i].run?"true":"false", cmd.axis[i].dir, cmd.axis[i].step);
+                    sep = ",";
+                }
+                if (m > 0 && (size_t)m < sizeof(out)) (void)snprintf(out + m, sizeof(out) - (size_t)m, "]}");
+                http_send(cfd, "200 OK", "application/json", out); close(cfd); continue;
             }
-            if (plen && strncmp(path, "/diag", plen) == 0) { char out[1024]; if (format_diag(h, out, sizeof(out)) == MA_OK) http_send(cfd, "200 OK", "application/json", out); else http_send(cfd, "500 Internal Server Error", "text/plain", "format error"); close(cfd); continue; }
+            if (plen && strncmp(path, "/diag", plen) == 0) { char out[2048]; if (format_diag(h, out, sizeof(out)) == MA_OK) http_send(cfd, "200 OK", "application/json", out); else http_send(cfd, "500 Internal Server Error", "text/plain", "format error"); close(cfd); continue; }
             http_send(cfd, "404 Not Found", "text/plain", "not found"); close(cfd); continue;
         } else if (strncmp(buf, "POST ", 5) == 0) {
             const char *path = buf + 5; const char *sp = strchr(path, ' '); size_t plen = sp ? (size_t)(sp - path) : 0; const char *hdr_end = strstr(buf, "\r\n\r\n"); const char *body = hdr_end ? (hdr_end + 4) : NULL;
-            if (plen && strncmp(path, "/control", plen) == 0) { int dir = 0, step = 0; int rc = parse_control_json(body, &dir, &step); if (rc == 0) { set_cmd_locked(h, true, dir, step); http_send(cfd, "200 OK", "application/json", "{\"ok\":true}"); } else { http_send(cfd, "400 Bad Request", "application/json", "{\"ok\":false}\n"); } close(cfd); continue; }
-            if (plen && strncmp(path, "/stop", plen) == 0) { set_cmd_locked(h, false, 0, 0); http_send(cfd, "200 OK", "application/json", "{\"ok\":true}"); close(cfd); continue; }
+            if (plen && strncmp(path, "/control", plen) == 0) {
+                int dir = 0, step = 0; int rc = parse_control_json(body, &dir, &step); int axis = parse_axis_json(h, body);
+                if (rc == 0 && axis != -2) {
+                    if (axis >= 0) set_axis_cmd(h, (uint16_t)axis, true, dir, step); else set_global_cmd(h, true, dir, step);
+                    http_send(cfd, "200 OK", "application/json", "{\"ok\":true}");
+                } else { http_send(cfd, "400 Bad Request", "application/json", "{\"ok\":false}\n"); }
+                close(cfd); continue;
+            }
+            if (plen && strncmp(path, "/stop", plen) == 0) {
+                int axis = parse_axis_json(h, body);
+                if (axis == -2) { http_send(cfd, "400 Bad Request", "application/json", "{\"ok\":false}\n"); close(cfd); continue; }
+                if (axis >= 0) set_axis_cmd(h, (uint16_t)axis, false, 0, 0); else set_global_cmd(h, false, 0, 0);
+                http_send(cfd, "200 OK", "application/json", "{\"ok\":true}"); close(cfd); continue;
+            }
             if (plen && strncmp(path, "/shutdown", plen) == 0) { h->stop = 1; http_send(cfd, "200 OK", "application/json", "{\"ok\":true}"); close(cfd); continue; }
             http_send(cfd, "404 Not Found", "text/plain", "not found"); close(cfd); continue;
         } else { http_send(cfd, "405 Method Not Allowed", "text/plain", "method not allowed"); close(cfd); }
@@ -275,6 +650,60 @@ static void check_slave_states(motor_api_handle_t *h) {
     ec_slave_config_state_t s; for (uint16_t i = 0; i < h->slave_count; ++i) { ecrt_slave_config_state(h->sc[i], &s); h->sc_state[i] = s; }
 }
 
+/* 内置任务入口：适配 ma_task_fn_t */
+static void task_domain_state(void *user, uint64_t cycle) { (void)cycle; check_domain_state((motor_api_handle_t *)user); }
+static void task_master_state(void *user, uint64_t cycle) { (void)cycle; check_master_state((motor_api_handle_t *)user); }
+static void task_slave_states(void *user, uint64_t cycle) { (void)cycle; check_slave_states((motor_api_handle_t *)user); }
+
+/*
+ * 函数: pick_task_phase
+ * 功能: 选择与已注册任务重叠最少的相位。
+ * 说明: 分频 a、b，相位 p、q 的两个任务会在同一周期到期，当且仅当 p ≡ q (mod gcd(a, b))。
+ */
+static uint32_t pick_task_phase(const motor_api_handle_t *h, uint32_t divisor) {
+    uint32_t best = 0; unsigned best_overlap = UINT_MAX;
+    for (uint32_t p = 0; p < divisor && best_overlap != 0; ++p) {
+        unsigned overlap = 0;
+        for (uint16_t t = 0; t < h->task_count; ++t) {
+            uint32_t a = divisor, b = h->tasks[t].divisor;
+            while (b) { uint32_t r = a % b; a = b; b = r; }
+            if (p % a == h->tasks[t].phase % a) overlap++;
+        }
+        if (overlap < best_overlap) { best_overlap = overlap; best = p; }
+    }
+    return best;
+}
+
+/*
+ * 函数: add_task
+ * 功能: 向任务表追加任务。
+ */
+static ma_status_t add_task(motor_api_handle_t *h, const char *name, uint32_t divisor, uint32_t phase, ma_task_fn_t fn, void *user) {
+    if (h->task_count >= MA_MAX_TASKS) return MA_ERR_RUNTIME;
+    if (divisor == 0) divisor = 1;
+    ma_task_t *t = &h->tasks[h->task_count];
+    t->name = name; t->divisor = divisor; t->fn = fn; t->user = user; t->runs = 0; t->max_ns = 0;
+    t->phase = phase == MA_TASK_AUTO_PHASE ? pick_task_phase(h, divisor) : phase % divisor;
+    h->task_count++;
+    return MA_OK;
+}
+
+/*
+ * 函数: run_tasks
+ * 功能: 执行本周期到期的任务并记录耗时。
+ */
+static void run_tasks(motor_api_handle_t *h, uint64_t cycle) {
+    for (uint16_t i = 0; i < h->task_count; ++i) {
+        ma_task_t *t = &h->tasks[i];
+        if (cycle % t->divisor != t->phase) continue;
+        uint64_t t0 = monotonic_ns();
+        t->fn(t->user, cycle);
+        uint64_t dt = monotonic_ns() - t0;
+        if (dt > t->max_ns) t->max_ns = dt;
+        t->runs++;
+    }
+}
+
 /*
  * 函数: motor_api_read_eni
  * 功能: 简易 ENI 解析，容错提取常见从站属性。
@@ -321,7 +750,14 @@ EXTERNFUNC ma_status_t motor_api_create(const char *eni_path,
     if (!out_handle || cycle_us == 0) return MA_ERR_PARAM;
     motor_api_handle_t *h = (motor_api_handle_t *)calloc(1, sizeof(*h)); if (!h) return MA_ERR_RUNTIME;
     h->cycle_us = cycle_us; h->dc_sync0_period_ns = (uint64_t)cycle_us * 1000ULL;
+    h->timer_fd = -1; h->cycle_fd = -1;
     pthread_mutex_init(&h->cmd_mutex, NULL);
+    h->cmd_back = 0; h->cmd_middle = 1; h->cmd_front = 2;
+    for (int p = 0; p < MA_TIMING_PHASES; ++p) hist_reset(&h->timing[p]);
+    hist_reset(&h->wd_stall_hist);
+    (void)add_task(h, "domain_state", 1, 0, task_domain_state, h);
+    (void)add_task(h, "master_state", 10, MA_TASK_AUTO_PHASE, task_master_state, h);
+    (void)add_task(h, "slave_states", 100, MA_TASK_AUTO_PHASE, task_slave_states, h);
     h->master = ecrt_request_master(0); if (!h->master) { free(h); return MA_ERR_INIT; }
     h->domain = ecrt_master_create_domain(h->master); if (!h->domain) { ecrt_release_master(h->master); free(h); return MA_ERR_INIT; }
 
@@ -391,7 +827,7 @@ EXTERNFUNC ma_status_t motor_api_create(const char *eni_path,
     if (ecrt_master_activate(h->master)) { ecrt_release_master(h->master); free(h); return MA_ERR_INIT; }
     h->domain_pd = ecrt_domain_data(h->domain); if (!h->domain_pd) { ecrt_release_master(h->master); free(h); return MA_ERR_INIT; }
     h->barrier_armed = 0; h->barrier_start_ns = 0; h->barrier_delay_ns = 1000000000ULL; h->motion_started = 0;
-    memset(h->seen_enabled, 0, sizeof(h->seen_enabled));
+    memset(&h->masks, 0, sizeof(h->masks)); h->seen_enabled = 0;
     *out_handle = (struct motor_api_handle *)h; if (out_slave_count) *out_slave_count = cnt;
     return MA_OK;
 }
@@ -402,6 +838,9 @@ EXTERNFUNC ma_status_t motor_api_create(const char *eni_path,
  */
 EXTERNFUNC ma_status_t motor_api_destroy(struct motor_api_handle *handle) {
     motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    motor_api_stop_watchdog(handle);
+    motor_api_stop_cyclic(handle);
+    motor_api_close_event_fds(handle);
     ecrt_release_master(h->master);
     pthread_mutex_destroy(&h->cmd_mutex);
     free(h);
@@ -431,11 +870,459 @@ EXTERNFUNC ma_status_t motor_api_stop_http(struct motor_api_handle *handle) {
 
 /*
  * 函数: motor_api_set_command
- * 功能: 更新运行命令（线程安全）。
+ * 功能: 更新全局运行命令（线程安全，不阻塞周期线程）。
  */
 EXTERNFUNC ma_status_t motor_api_set_command(struct motor_api_handle *handle, bool run, int dir, int step) {
     motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
-    set_cmd_locked(h, run, dir, step);
+    set_global_cmd(h, run, dir, step);
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_set_axis_commands
+ * 功能: 一次发布多个轴的独立命令，周期线程在同一周期内全部生效。
+ */
+EXTERNFUNC ma_status_t motor_api_set_axis_commands(struct motor_api_handle *handle, uint32_t axis_mask, const ma_axis_command_t *cmds) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !cmds) return MA_ERR_PARAM;
+    const uint32_t valid = h->slave_count >= 32 ? 0xFFFFFFFFu : ((1u << h->slave_count) - 1u);
+    if (axis_mask & ~valid) return MA_ERR_PARAM;
+    pthread_mutex_lock(&h->cmd_mutex);
+    for (uint16_t i = 0; i < h->slave_count; ++i) {
+        if (!(axis_mask & (1u << i))) continue;
+        h->cmd.axis[i] = clamp_command(cmds[i].run, cmds[i].dir, cmds[i].step);
+    }
+    h->cmd.axis_override |= axis_mask;
+    publish_cmd_locked(h);
+    pthread_mutex_unlock(&h->cmd_mutex);
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_clear_axis_commands
+ * 功能: 撤销独立命令，相应轴恢复跟随全局命令。
+ */
+EXTERNFUNC ma_status_t motor_api_clear_axis_commands(struct motor_api_handle *handle, uint32_t axis_mask) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    pthread_mutex_lock(&h->cmd_mutex);
+    h->cmd.axis_override &= ~axis_mask;
+    publish_cmd_locked(h);
+    pthread_mutex_unlock(&h->cmd_mutex);
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_get_status_masks
+ * 功能: 拷贝最近一次周期的全轴状态位掩码。
+ */
+EXTERNFUNC ma_status_t motor_api_get_status_masks(struct motor_api_handle *handle, ma_status_masks_t *out_masks) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !out_masks) return MA_ERR_PARAM;
+    *out_masks = h->masks;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_add_task
+ * 功能: 注册多速率任务。
+ */
+EXTERNFUNC ma_status_t motor_api_add_task(struct motor_api_handle *handle, const char *name, uint32_t divisor, uint32_t phase, ma_task_fn_t fn, void *user) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !name || !fn) return MA_ERR_PARAM;
+    if (h->cyclic_running) return MA_ERR_RUNTIME;
+    return add_task(h, name, divisor, phase, fn, user);
+}
+
+/*
+ * 函数: motor_api_get_task_info
+ * 功能: 获取任务信息与耗时统计。
+ */
+EXTERNFUNC ma_status_t motor_api_get_task_info(struct motor_api_handle *handle, uint16_t index, ma_task_info_t *out_info) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !out_info || index >= h->task_count) return MA_ERR_PARAM;
+    const ma_task_t *t = &h->tasks[index];
+    out_info->name = t->name; out_info->divisor = t->divisor; out_info->phase = t->phase;
+    out_info->runs = t->runs; out_info->max_ns = t->max_ns;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_get_overruns
+ * 功能: 获取实时周期线程的超时统计与受控停机状态。
+ */
+EXTERNFUNC ma_status_t motor_api_get_overruns(struct motor_api_handle *handle, uint64_t *out_overruns, bool *out_tripped) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    if (out_overruns) *out_overruns = h->cyclic_overruns;
+    if (out_tripped) *out_tripped = h->overrun_tripped != 0;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_get_timing
+ * 功能: 获取指定周期阶段的耗时统计摘要。
+ */
+EXTERNFUNC ma_status_t motor_api_get_timing(struct motor_api_handle *handle, ma_timing_phase_t phase, ma_timing_summary_t *out_summary) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !out_summary) return MA_ERR_PARAM;
+    if ((int)phase < 0 || phase >= MA_TIMING_PHASES) return MA_ERR_PARAM;
+    hist_summary(&h->timing[phase], out_summary);
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_reset_timing
+ * 功能: 清空全部阶段的耗时统计。
+ */
+EXTERNFUNC ma_status_t motor_api_reset_timing(struct motor_api_handle *handle) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    for (int p = 0; p < MA_TIMING_PHASES; ++p) hist_reset(&h->timing[p]);
+    return MA_OK;
+}
+
+/*
+ * 函数: prefault_stack
+ * 功能: 逐页写入栈空间，使周期内的栈访问不再产生缺页。
+ */
+static void prefault_stack(size_t bytes) {
+    volatile unsigned char buf[4096];
+    if (bytes > sizeof(buf)) prefault_stack(bytes - sizeof(buf));
+    for (size_t i = 0; i < sizeof(buf); i += 64) buf[i] = 0;
+}
+
+/*
+ * 函数: cpu_relax
+ * 功能: 自旋等待提示，降低自旋对超线程兄弟核的干扰。
+ */
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/*
+ * 函数: wait_until
+ * 功能: 等待到 CLOCK_MONOTONIC 绝对时间 abs_ns：先睡眠到 abs_ns - spin_ns，再自旋到 abs_ns。
+ * 说明: CLOCK_MONOTONIC 经 vDSO 读取 TSC，自旋期间不陷入内核。
+ */
+static void wait_until(uint64_t abs_ns, uint64_t spin_ns) {
+    if (abs_ns > spin_ns) {
+        uint64_t t = abs_ns - spin_ns;
+        struct timespec ts; ts.tv_sec = (time_t)(t / 1000000000ULL); ts.tv_nsec = (long)(t % 1000000000ULL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) { }
+    }
+    if (spin_ns) { while (monotonic_ns() < abs_ns) cpu_relax(); }
+}
+
+/*
+ * 函数: cyclic_thread_fn
+ * 功能: 实时周期线程，按绝对截止时间调用 motor_api_run_once。
+ */
+static void *cyclic_thread_fn(void *arg) {
+    motor_api_handle_t *h = (motor_api_handle_t *)arg;
+    if (h->rt.prefault_stack) prefault_stack(h->rt.prefault_stack);
+    const uint64_t period = (uint64_t)h->cycle_us * 1000ULL;
+    const uint64_t offset = h->rt.send_offset_ns < period ? h->rt.send_offset_ns : 0;
+    uint64_t next = monotonic_ns() + period;
+    while (!h->cyclic_stop) {
+        wait_until(next, h->rt.spin_margin_ns);
+        uint64_t woke = monotonic_ns();
+        hist_record(&h->timing[MA_TIMING_WAKEUP], woke - next);
+        if (h->cyclic_stop) break;
+        /* 上一周期超时：本周期按策略降级，连续超时达到阈值时受控停机 */
+        ma_overrun_policy_t degrade = MA_OVERRUN_RUN;
+        if (h->cyclic_consecutive) {
+            degrade = h->rt.overrun_policy;
+            if (h->rt.overrun_stop_after && h->cyclic_consecutive >= h->rt.overrun_stop_after && !h->overrun_tripped) {
+                h->overrun_tripped = 1;
+                printf("[RT] %u consecutive overruns, quick stop\n", h->cyclic_consecutive);
+            }
+        }
+        run_cycle(h, next + offset, degrade, h->rt.pipelined);
+        h->cyclic_cycles++;
+        next += period;
+        /* 已错过下一截止时间：按整周期跳过，保持相位 */
+        uint64_t now = monotonic_ns();
+        if (now >= next) {
+            uint64_t skip = (now - next) / period + 1; next += skip * period; h->cyclic_missed += skip;
+            h->cyclic_overruns++; h->cyclic_consecutive++;
+        } else {
+            h->cyclic_consecutive = 0;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * 函数: motor_api_start_cyclic
+ * 功能: 应用实时配置并创建周期线程。
+ */
+EXTERNFUNC ma_status_t motor_api_start_cyclic(struct motor_api_handle *handle, const ma_rt_config_t *rt) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    if (h->cyclic_running || h->timer_fd >= 0) return MA_ERR_RUNTIME;
+    if (rt) h->rt = *rt; else { memset(&h->rt, 0, sizeof(h->rt)); h->rt.cpu = -1; }
+    h->cyclic_stop = 0; h->cyclic_cycles = 0; h->cyclic_missed = 0;
+    h->cyclic_overruns = 0; h->cyclic_consecutive = 0; h->overrun_tripped = 0;
+    h->pipe_staged = 0;
+
+    if (h->rt.lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        printf("[RT] mlockall failed: %s\n", strerror(errno));
+    }
+
+    pthread_attr_t attr; pthread_attr_init(&attr);
+    if (h->rt.prefault_stack) {
+        size_t stack = h->rt.prefault_stack + 256 * 1024;
+        if (stack < (size_t)PTHREAD_STACK_MIN) stack = (size_t)PTHREAD_STACK_MIN;
+        pthread_attr_setstacksize(&attr, stack);
+    }
+    if (h->rt.cpu >= 0) {
+        cpu_set_t set; CPU_ZERO(&set); CPU_SET(h->rt.cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+    if (h->rt.priority > 0) {
+        struct sched_param sp; memset(&sp, 0, sizeof(sp)); sp.sched_priority = h->rt.priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &sp);
+    }
+    int rc = pthread_create(&h->cyclic_thread, &attr, cyclic_thread_fn, h);
+    if (rc == EPERM && h->rt.priority > 0) {
+        /* 无实时权限：退回默认调度策略 */
+        printf("[RT] SCHED_FIFO priority %d not permitted, using default policy\n", h->rt.priority);
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        rc = pthread_create(&h->cyclic_thread, &attr, cyclic_thread_fn, h);
+    }
+    pthread_attr_destroy(&attr);
+    if (rc != 0) return MA_ERR_RUNTIME;
+    h->cyclic_running = 1;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_stop_cyclic
+ * 功能: 请求周期线程退出并等待。
+ */
+EXTERNFUNC ma_status_t motor_api_stop_cyclic(struct motor_api_handle *handle) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    if (!h->cyclic_running) return MA_OK;
+    h->cyclic_stop = 1;
+    pthread_join(h->cyclic_thread, NULL);
+    h->cyclic_running = 0;
+    printf("[RT] cyclic thread stopped: cycles=%llu overruns=%llu missed=%llu\n",
+           (unsigned long long)h->cyclic_cycles, (unsigned long long)h->cyclic_overruns,
+           (unsigned long long)h->cyclic_missed);
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_open_timer_fd
+ * 功能: 创建按绝对截止时间到期的周期定时器。
+ */
+EXTERNFUNC ma_status_t motor_api_open_timer_fd(struct motor_api_handle *handle, int *out_fd) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !out_fd) return MA_ERR_PARAM;
+    if (h->cyclic_running) return MA_ERR_RUNTIME;
+    if (h->timer_fd < 0) {
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd < 0) { printf("[EVT] timerfd_create failed: %s\n", strerror(errno)); return MA_ERR_RUNTIME; }
+        const uint64_t period = (uint64_t)h->cycle_us * 1000ULL;
+        h->timer_start_ns = monotonic_ns(); h->timer_expirations = 0;
+        const uint64_t first = h->timer_start_ns + period;
+        struct itimerspec spec; memset(&spec, 0, sizeof(spec));
+        spec.it_value.tv_sec = (time_t)(first / 1000000000ULL); spec.it_value.tv_nsec = (long)(first % 1000000000ULL);
+        spec.it_interval.tv_sec = (time_t)(period / 1000000000ULL); spec.it_interval.tv_nsec = (long)(period % 1000000000ULL);
+        if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0) {
+            printf("[EVT] timerfd_settime failed: %s\n", strerror(errno));
+            close(fd);
+            return MA_ERR_RUNTIME;
+        }
+        h->timer_fd = fd;
+    }
+    *out_fd = h->timer_fd;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_dispatch_timer
+ * 功能: 定时器到期时执行一次周期控制；错过的周期跳过并计入超时统计。
+ */
+EXTERNFUNC ma_status_t motor_api_dispatch_timer(struct motor_api_handle *handle, uint64_t *out_expirations) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    if (out_expirations) *out_expirations = 0;
+    if (h->timer_fd < 0) return MA_ERR_RUNTIME;
+    uint64_t n = 0;
+    if (read(h->timer_fd, &n, sizeof(n)) != (ssize_t)sizeof(n) || n == 0) return MA_OK; /* 尚未到期 */
+    h->timer_expirations += n;
+    const uint64_t deadline = h->timer_start_ns + h->timer_expirations * (uint64_t)h->cycle_us * 1000ULL;
+    const uint64_t now = monotonic_ns();
+    hist_record(&h->timing[MA_TIMING_WAKEUP], now > deadline ? now - deadline : 0);
+    if (n > 1) { h->cyclic_missed += n - 1; h->cyclic_overruns++; }
+    run_cycle(h, 0, MA_OVERRUN_RUN, false);
+    if (out_expirations) *out_expirations = n;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_open_cycle_fd
+ * 功能: 创建周期完成通知 eventfd。
+ */
+EXTERNFUNC ma_status_t motor_api_open_cycle_fd(struct motor_api_handle *handle, int *out_fd) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !out_fd) return MA_ERR_PARAM;
+    if (h->cycle_fd < 0) {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) { printf("[EVT] eventfd failed: %s\n", strerror(errno)); return MA_ERR_RUNTIME; }
+        h->cycle_fd = fd;
+    }
+    *out_fd = h->cycle_fd;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_close_event_fds
+ * 功能: 关闭周期定时器与周期完成通知描述符。
+ */
+EXTERNFUNC ma_status_t motor_api_close_event_fds(struct motor_api_handle *handle) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    if (h->timer_fd >= 0) { close(h->timer_fd); h->timer_fd = -1; }
+    if (h->cycle_fd >= 0) { close(h->cycle_fd); h->cycle_fd = -1; }
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_poll_snapshot
+ * 功能: 按序列锁读取快照：序号为奇数或读取前后序号变化时重试，周期线程从不等待。
+ */
+EXTERNFUNC ma_status_t motor_api_poll_snapshot(struct motor_api_handle *handle, uint64_t last_cycle,
+                                               ma_snapshot_t *out_snapshot, bool *out_fresh) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !out_snapshot || !out_fresh) return MA_ERR_PARAM;
+    ma_snapshot_t copy;
+    for (;;) {
+        uint32_t begin = __atomic_load_n(&h->snap_seq, __ATOMIC_ACQUIRE);
+        if (begin & 1u) { cpu_relax(); continue; }
+        memcpy(&copy, &h->snap, sizeof(copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&h->snap_seq, __ATOMIC_RELAXED) == begin) break;
+    }
+    *out_fresh = copy.cycle > last_cycle;
+    if (*out_fresh) *out_snapshot = copy;
+    return MA_OK;
+}
+
+/*
+ * 函数: watchdog_quick_stop
+ * 功能: 周期线程停在总线收发之外时，由看门狗完成一次收发并写入快速停止。
+ * 返回: 1 已发送；0 周期线程正占用总线
+ */
+static int watchdog_quick_stop(motor_api_handle_t *h) {
+    int expected = 0;
+    if (!__atomic_compare_exchange_n(&h->bus_owner, &expected, 2, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return 0;
+    ecrt_master_receive(h->master);
+    ecrt_domain_process(h->domain);
+    quick_stop_outputs(h);
+    ecrt_domain_queue(h->domain);
+    ecrt_master_send(h->master);
+    __atomic_store_n(&h->bus_owner, 0, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/*
+ * 函数: watchdog_thread_fn
+ * 功能: 看门狗线程：按检查周期比较心跳时间，停滞超过时限时触发受控停机并输出诊断，
+ *       心跳恢复后记录停滞时长。
+ */
+static void *watchdog_thread_fn(void *arg) {
+    motor_api_handle_t *h = (motor_api_handle_t *)arg;
+    const uint64_t period = (uint64_t)h->wd.check_period_us * 1000ULL;
+    const uint64_t timeout = (uint64_t)h->wd.stall_timeout_us * 1000ULL;
+    uint64_t stall_start = 0, stall_beats = 0;
+    while (!h->wd_stop) {
+        struct timespec ts; ts.tv_sec = (time_t)(period / 1000000000ULL); ts.tv_nsec = (long)(period % 1000000000ULL);
+        nanosleep(&ts, NULL);
+        uint64_t last = __atomic_load_n(&h->heartbeat_ns, __ATOMIC_ACQUIRE);
+        uint64_t now = monotonic_ns(); uint64_t gap = now > last ? now - last : 0;
+        if (gap > h->wd_max_gap_ns) h->wd_max_gap_ns = gap;
+        if (__atomic_load_n(&h->wd_stalled, __ATOMIC_RELAXED)) {
+            if (__atomic_load_n(&h->heartbeats, __ATOMIC_RELAXED) != stall_beats) {
+                hist_record(&h->wd_stall_hist, last - stall_start);
+                printf("[WD] cyclic loop resumed after %.3f ms\n", (double)(last - stall_start) / 1e6);
+                __atomic_store_n(&h->wd_stalled, 0, __ATOMIC_RELEASE);
+            } else {
+                (void)watchdog_quick_stop(h);
+            }
+        } else if (gap > timeout) {
+            stall_start = last; stall_beats = __atomic_load_n(&h->heartbeats, __ATOMIC_RELAXED);
+            __atomic_store_n(&h->wd_stalled, 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&h->wd_tripped, 1, __ATOMIC_RELEASE);
+            h->wd_stalls++;
+            printf("[WD] no heartbeat for %.3f ms (timeout %.3f ms), quick stop\n", (double)gap / 1e6, (double)timeout / 1e6);
+            /* 停滞的周期线程可能仍在写域数据，这里只输出原子统计 */
+            char diag[2048];
+            if (format_timing_diag(h, diag, sizeof(diag)) == MA_OK) printf("[WD] diag: %s\n", diag);
+            if (!watchdog_quick_stop(h)) printf("[WD] cyclic thread holds the bus, quick stop deferred until it resumes\n");
+        }
+    }
+    return NULL;
+}
+
+/*
+ * 函数: motor_api_start_watchdog
+ * 功能: 启动带外看门狗线程。
+ */
+EXTERNFUNC ma_status_t motor_api_start_watchdog(struct motor_api_handle *handle, const ma_watchdog_config_t *cfg) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !cfg) return MA_ERR_PARAM;
+    if (h->wd_running) return MA_ERR_RUNTIME;
+    h->wd = *cfg;
+    if (h->wd.check_period_us == 0) h->wd.check_period_us = 1000;
+    if (h->wd.stall_timeout_us < h->wd.check_period_us) h->wd.stall_timeout_us = h->wd.check_period_us;
+    h->wd_stop = 0; h->wd_stalls = 0; h->wd_max_gap_ns = 0;
+    __atomic_store_n(&h->wd_stalled, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->wd_tripped, 0, __ATOMIC_RELAXED);
+    hist_reset(&h->wd_stall_hist);
+    __atomic_store_n(&h->heartbeat_ns, monotonic_ns(), __ATOMIC_RELEASE);
+
+    pthread_attr_t attr; pthread_attr_init(&attr);
+    if (h->wd.cpu >= 0) {
+        cpu_set_t set; CPU_ZERO(&set); CPU_SET(h->wd.cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+    if (h->wd.priority > 0) {
+        struct sched_param sp; memset(&sp, 0, sizeof(sp)); sp.sched_priority = h->wd.priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &sp);
+    }
+    int rc = pthread_create(&h->wd_thread, &attr, watchdog_thread_fn, h);
+    if (rc == EPERM && h->wd.priority > 0) {
+        printf("[WD] SCHED_FIFO priority %d not permitted, using default policy\n", h->wd.priority);
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        rc = pthread_create(&h->wd_thread, &attr, watchdog_thread_fn, h);
+    }
+    pthread_attr_destroy(&attr);
+    if (rc != 0) return MA_ERR_RUNTIME;
+    h->wd_running = 1;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_stop_watchdog
+ * 功能: 停止看门狗线程并等待退出。
+ */
+EXTERNFUNC ma_status_t motor_api_stop_watchdog(struct motor_api_handle *handle) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    if (!h->wd_running) return MA_OK;
+    h->wd_stop = 1;
+    pthread_join(h->wd_thread, NULL);
+    h->wd_running = 0;
+    return MA_OK;
+}
+
+/*
+ * 函数: motor_api_get_watchdog_stats
+ * 功能: 获取看门狗统计。
+ */
+EXTERNFUNC ma_status_t motor_api_get_watchdog_stats(struct motor_api_handle *handle, ma_watchdog_stats_t *out_stats) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h || !out_stats) return MA_ERR_PARAM;
+    out_stats->heartbeats = __atomic_load_n(&h->heartbeats, __ATOMIC_RELAXED);
+    out_stats->stalls = h->wd_stalls;
+    out_stats->max_gap_ns = h->wd_max_gap_ns;
+    out_stats->max_stall_ns = __atomic_load_n(&h->wd_stall_hist.max, __ATOMIC_RELAXED);
+    out_stats->stalled = __atomic_load_n(&h->wd_stalled, __ATOMIC_ACQUIRE) != 0;
+    out_stats->tripped = __atomic_load_n(&h->wd_tripped, __ATOMIC_ACQUIRE) != 0;
     return MA_OK;
 }
 
@@ -449,22 +1336,16 @@ EXTERNFUNC ma_status_t motor_api_format_diag_json(struct motor_api_handle *handl
 }
 
 /*
- * 函数: motor_api_run_once
- * 功能: 周期性控制入口，包含状态机推进、目标更新、同步栅栏与调试输出。
- * 注意: 需以固定周期调用（例如 4ms）。
+ * 函数: compute_outputs
+ * 功能: 正常周期的计算阶段：逐轴推进 CiA-402 状态机、更新 CSP 目标与同步栅栏。
  */
-EXTERNFUNC ma_status_t motor_api_run_once(struct motor_api_handle *handle) {
-    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
-    ecrt_master_application_time(h->master, monotonic_ns());
-    ecrt_master_receive(h->master);
-    ecrt_domain_process(h->domain);
-    ecrt_master_sync_slave_clocks(h->master);
-    check_domain_state(h); check_master_state(h); check_slave_states(h);
+static void compute_outputs(motor_api_handle_t *h, const uint16_t *sw) {
     static int dbg_tick = 0; dbg_tick++;
+    /* 每周期只取一次命令块，不加锁 */
+    const ma_command_block_t *cmd = acquire_cmd(h);
     /* 逐轴推进状态机与写入控制字/模式 */
     for (uint16_t i = 0; i < h->slave_count; ++i) {
-        uint16_t status_i = EC_READ_U16(h->domain_pd + h->in[i].statusword);
-        if ((status_i & 0x6F) == 0x27) h->seen_enabled[i] = true;
+        uint16_t status_i = sw[i];
         uint16_t control_i = 0x06;
         if (!h->servo_enabled[i]) {
             /* 依据 CiA-402 标准用状态字低位掩码推进控制字序列 */
@@ -518,12 +1399,12 @@ EXTERNFUNC ma_status_t motor_api_run_once(struct motor_api_handle *handle) {
                 }
             } else {
                 /* 延迟栅栏已触发：按命令增量推进目标（限幅与预热） */
-                pthread_mutex_lock(&h->cmd_mutex); bool run = h->cmd_run; int dir = h->cmd_dir; int step = h->cmd_step; pthread_mutex_unlock(&h->cmd_mutex);
-                int delta = run ? (dir * step) : 0;
+                const ma_axis_command_t *c = (cmd->axis_override & (1u << i)) ? &cmd->axis[i] : &cmd->global;
+                int delta = c->run ? (c->dir * c->step) : 0;
                 if (delta > MA_MAX_DELTA_PER_CYCLE) delta = MA_MAX_DELTA_PER_CYCLE;
                 if (delta < -MA_MAX_DELTA_PER_CYCLE) delta = -MA_MAX_DELTA_PER_CYCLE;
-                if (h->csp_warmup[i] > 0) { h->csp_target[i] = EC_READ_S32(h->domain_pd + h->in[i].actualPosition); h->csp_warmup[i]--; }
-                else { h->csp_target[i] += delta; }
+                if (h->csp_warmup[i] > 0) { h->csp_target[i] = EC_READ_S32(h->domain_pd + h->in[i].actualPosition); h->csp_warmup[i]--; h->csp_delta[i] = 0; }
+                else { h->csp_target[i] += delta; h->csp_delta[i] = delta; }
                 EC_WRITE_S32(h->domain_pd + h->out[i].targetPosition, h->csp_target[i]);
                 EC_WRITE_U16(h->domain_pd + h->out[i].controlWord, 0x0F);
                 EC_WRITE_S8(h->domain_pd + h->out[i].workModeOut, (int8_t)MA_MODE_CSP);
@@ -539,8 +1420,10 @@ EXTERNFUNC ma_status_t motor_api_run_once(struct motor_api_handle *handle) {
     }
     {
         /* 栅栏逻辑：检测全轴使能后武装，延时 1s 后统一开始运动 */
-        pthread_mutex_lock(&h->cmd_mutex); bool run = h->cmd_run; pthread_mutex_unlock(&h->cmd_mutex);
-        int all_enabled = 1; for (uint16_t i = 0; i < h->slave_count; ++i) all_enabled = all_enabled && h->seen_enabled[i];
+        /* 全局命令或任一轴的独立命令要求运行时武装栅栏 */
+        bool run = cmd->global.run;
+        for (uint16_t i = 0; i < h->slave_count && !run; ++i) run = (cmd->axis_override & (1u << i)) && cmd->axis[i].run;
+        int all_enabled = h->masks.axes && (h->seen_enabled & h->masks.axes) == h->masks.axes;
         if (!h->motion_started && run) {
             if (!h->barrier_armed && all_enabled) {
                 h->barrier_armed = 1; h->barrier_start_ns = monotonic_ns();
@@ -561,8 +1444,167 @@ EXTERNFUNC ma_status_t motor_api_run_once(struct motor_api_handle *handle) {
             }
         }
     }
-    /* 提交域数据并发送到主站 */
+}
+
+/*
+ * 函数: degrade_outputs
+ * 功能: 超时后的降级周期：跳过状态机与命令处理，按策略写入目标位置，保证目标连续。
+ * 说明: 域数据保留上一周期的输出，MA_OVERRUN_RESEND 无需重写。
+ */
+static void degrade_outputs(motor_api_handle_t *h, ma_overrun_policy_t policy) {
+    for (uint16_t i = 0; i < h->slave_count; ++i) {
+        if (!h->servo_enabled[i]) continue;
+        if (policy == MA_OVERRUN_HOLD) {
+            h->csp_target[i] = EC_READ_S32(h->domain_pd + h->in[i].actualPosition);
+            h->csp_delta[i] = 0;
+        } else if (policy == MA_OVERRUN_EXTRAPOLATE) {
+            h->csp_target[i] += h->csp_delta[i];
+        } else {
+            continue;
+        }
+        EC_WRITE_S32(h->domain_pd + h->out[i].targetPosition, h->csp_target[i]);
+    }
+}
+
+/*
+ * 函数: quick_stop_outputs
+ * 功能: 受控停机：全轴目标保持在实际位置并写快速停止控制字 0x0002。
+ */
+static void quick_stop_outputs(motor_api_handle_t *h) {
+    for (uint16_t i = 0; i < h->slave_count; ++i) {
+        h->csp_target[i] = EC_READ_S32(h->domain_pd + h->in[i].actualPosition);
+        h->csp_delta[i] = 0;
+        EC_WRITE_S32(h->domain_pd + h->out[i].targetPosition, h->csp_target[i]);
+        EC_WRITE_U16(h->domain_pd + h->out[i].controlWord, 0x0002);
+    }
+}
+
+/*
+ * 函数: stage_outputs
+ * 功能: 流水线模式：发送之后把本周期算出的输出暂存，下一周期发送前写回。
+ * 说明: 接收时主站把回传帧拷回域内存，输出区会被还原为上一帧发出的值。
+ */
+static void stage_outputs(motor_api_handle_t *h) {
+    for (uint16_t i = 0; i < h->slave_count; ++i) {
+        h->pipe_control[i] = EC_READ_U16(h->domain_pd + h->out[i].controlWord);
+        h->pipe_mode[i] = EC_READ_S8(h->domain_pd + h->out[i].workModeOut);
+        h->pipe_target[i] = EC_READ_S32(h->domain_pd + h->out[i].targetPosition);
+    }
+    h->pipe_staged = 1;
+}
+
+/*
+ * 函数: restore_outputs
+ * 功能: 流水线模式：把上一周期暂存的输出写回域数据，尚无暂存时保持域数据不变。
+ */
+static void restore_outputs(motor_api_handle_t *h) {
+    if (!h->pipe_staged) return;
+    for (uint16_t i = 0; i < h->slave_count; ++i) {
+        EC_WRITE_U16(h->domain_pd + h->out[i].controlWord, h->pipe_control[i]);
+        EC_WRITE_S8(h->domain_pd + h->out[i].workModeOut, h->pipe_mode[i]);
+        EC_WRITE_S32(h->domain_pd + h->out[i].targetPosition, h->pipe_target[i]);
+    }
+}
+
+/*
+ * 函数: publish_snapshot
+ * 功能: 发送完成后以序列锁发布本周期快照，并通知周期完成描述符。
+ * 说明: 只有持有总线的一方写快照，写入不等待读者。
+ */
+static void publish_snapshot(motor_api_handle_t *h, uint64_t t_start, const uint16_t *sw) {
+    const uint32_t seq = h->snap_seq;
+    __atomic_store_n(&h->snap_seq, seq + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    ma_snapshot_t *s = &h->snap;
+    s->cycle = h->cycle_no + 1;
+    s->timestamp_ns = t_start;
+    s->axis_count = h->slave_count;
+    for (uint16_t i = 0; i < h->slave_count; ++i) {
+        s->statusword[i] = sw[i];
+        s->error_code[i] = EC_READ_U16(h->domain_pd + h->in[i].errorCode);
+        s->actual_position[i] = EC_READ_S32(h->domain_pd + h->in[i].actualPosition);
+        s->target_position[i] = EC_READ_S32(h->domain_pd + h->out[i].targetPosition);
+    }
+    s->masks = h->masks;
+    __atomic_store_n(&h->snap_seq, seq + 2u, __ATOMIC_RELEASE);
+
+    if (h->cycle_fd >= 0) {
+        const uint64_t one = 1;
+        ssize_t rc = write(h->cycle_fd, &one, sizeof(one));
+        (void)rc; /* 计数饱和时丢弃本次通知 */
+    }
+}
+
+/*
+ * 函数: motor_api_run_once
+ * 功能: 周期性控制入口，包含状态机推进、目标更新、同步栅栏与调试输出。
+ * 注意: 需以固定周期调用（例如 4ms）。
+ */
+EXTERNFUNC ma_status_t motor_api_run_once(struct motor_api_handle *handle) {
+    motor_api_handle_t *h = (motor_api_handle_t *)handle; if (!h) return MA_ERR_PARAM;
+    run_cycle(h, 0, MA_OVERRUN_RUN, false);
+    return MA_OK;
+}
+
+/*
+ * 函数: run_cycle
+ * 功能: 执行一次周期控制；send_at 非 0 时在该时刻（CLOCK_MONOTONIC 纳秒）发送，
+ *       degrade 非 MA_OVERRUN_RUN 时以降级方式代替正常计算。
+ *       pipelined 为 true 时先发送上一周期暂存的输出，再计算并暂存下一帧的输出；
+ *       受控停机的输出不经流水线，本周期直接发出。
+ */
+static void run_cycle(motor_api_handle_t *h, uint64_t send_at, ma_overrun_policy_t degrade, bool pipelined) {
+    /* 看门狗正在发送快速停止帧时跳过本周期 */
+    int expected = 0;
+    if (!__atomic_compare_exchange_n(&h->bus_owner, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+    const uint64_t t_start = monotonic_ns();
+    if (h->last_cycle_start_ns) hist_record(&h->timing[MA_TIMING_PERIOD], t_start - h->last_cycle_start_ns);
+    h->last_cycle_start_ns = t_start;
+    ecrt_master_application_time(h->master, t_start);
+    ecrt_master_receive(h->master);
+    ecrt_domain_process(h->domain);
+    ecrt_master_sync_slave_clocks(h->master);
+    /* 采集全轴状态字并计算状态位掩码 */
+    uint16_t sw[MA_MAX_SLAVES] = {0};
+    for (uint16_t i = 0; i < h->slave_count; ++i) sw[i] = EC_READ_U16(h->domain_pd + h->in[i].statusword);
+    update_status_masks(h, sw);
+    const uint64_t t_received = monotonic_ns();
+    hist_record(&h->timing[MA_TIMING_RECEIVE], t_received - t_start);
+    const int quick = h->overrun_tripped || __atomic_load_n(&h->wd_tripped, __ATOMIC_ACQUIRE);
+    if (quick) {
+        quick_stop_outputs(h);
+    } else if (pipelined) {
+        restore_outputs(h);
+    } else if (degrade != MA_OVERRUN_RUN) {
+        degrade_outputs(h, degrade);
+    } else {
+        compute_outputs(h, sw);
+    }
+    /* 提交域数据并发送到主站；指定发送时刻时等待到该时刻，帧在周期内的发出时间固定 */
+    uint64_t t_send = monotonic_ns();
+    if (!pipelined) hist_record(&h->timing[MA_TIMING_COMPUTE], t_send - t_received);
+    if (send_at) {
+        wait_until(send_at, h->rt.spin_margin_ns);
+        t_send = monotonic_ns();
+        hist_record(&h->timing[MA_TIMING_SEND_JITTER], t_send > send_at ? t_send - send_at : 0);
+    }
     ecrt_domain_queue(h->domain);
     ecrt_master_send(h->master);
-    return MA_OK;
+    const uint64_t t_end = monotonic_ns();
+    hist_record(&h->timing[MA_TIMING_SEND], t_end - t_send);
+    /* 发布心跳；状态检查等慢任务在发送之后执行，不推迟帧的发出 */
+    __atomic_store_n(&h->heartbeat_ns, t_end, __ATOMIC_RELEASE);
+    __atomic_store_n(&h->heartbeats, h->heartbeats + 1, __ATOMIC_RELAXED);
+    publish_snapshot(h, t_start, sw);
+    if (pipelined) {
+        /* 为下一帧计算；降级周期已按时发出暂存值，由降级策略代替计算生成下一帧，目标保持连续 */
+        if (!quick) {
+            const uint64_t t_compute = monotonic_ns();
+            if (degrade != MA_OVERRUN_RUN) degrade_outputs(h, degrade); else compute_outputs(h, sw);
+            hist_record(&h->timing[MA_TIMING_COMPUTE], monotonic_ns() - t_compute);
+        }
+        stage_outputs(h);
+    }
+    run_tasks(h, h->cycle_no++);
+    __atomic_store_n(&h->bus_owner, 0, __ATOMIC_RELEASE);
 }
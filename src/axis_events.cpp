@@ -0,0 +1,114 @@
+#include "axis_events.hpp"
+
+AxisEventStream::AxisEventStream() : mask_(0), status_mask_(0xFFFF), primed_(false), head_(0) {}
+
+bool AxisEventStream::reset(size_t axes, size_t capacity, uint16_t status_mask) {
+  if (axes == 0 || axes > 0xFFFF || capacity == 0) return false;
+  size_t size = 2;
+  while (size < capacity) size <<= 1;
+
+  // 槽含原子成员不可移动，整体替换而不是resize
+  std::vector<Slot> slots(size);
+  slots_.swap(slots);
+  mask_ = size - 1;
+  status_mask_ = status_mask;
+  primed_ = false;
+  last_status_.assign(axes, 0);
+  last_mode_.assign(axes, 0);
+  last_error_.assign(axes, 0);
+  head_.store(0, std::memory_order_release);
+  return true;
+}
+
+void AxisEventStream::detect(uint64_t cycle, uint64_t timestamp_ns, const uint16_t* status, const int8_t* mode,
+                             const uint16_t* error) {
+  const size_t n = last_status_.size();
+  if (!primed_) {
+    for (size_t m = 0; m < n; ++m) {
+      last_status_[m] = status[m] & status_mask_;
+      last_mode_[m] = mode[m];
+      last_error_[m] = error[m];
+    }
+    primed_ = true;
+    return;
+  }
+
+  AxisEvent event;
+  event.cycle = cycle;
+  event.timestamp_ns = timestamp_ns;
+  event.reserved = 0;
+  for (size_t m = 0; m < n; ++m) {
+    const uint16_t sw = status[m] & status_mask_;
+    // 绝大多数周期三个字段都不变，只做三次比较
+    if (sw == last_status_[m] && mode[m] == last_mode_[m] && error[m] == last_error_[m]) continue;
+
+    event.axis = static_cast<uint16_t>(m);
+    if (sw != last_status_[m]) {
+      event.field = AxisEventField::StatusWord;
+      event.old_value = last_status_[m];
+      event.new_value = sw;
+      push(event);
+      last_status_[m] = sw;
+    }
+    if (mode[m] != last_mode_[m]) {
+      event.field = AxisEventField::ModeDisplay;
+      event.old_value = static_cast<uint8_t>(last_mode_[m]);
+      event.new_value = static_cast<uint8_t>(mode[m]);
+      push(event);
+      last_mode_[m] = mode[m];
+    }
+    if (error[m] != last_error_[m]) {
+      event.field = AxisEventField::ErrorCode;
+      event.old_value = last_error_[m];
+      event.new_value = error[m];
+      push(event);
+      last_error_[m] = error[m];
+    }
+  }
+}
+
+void AxisEventStream::push(const AxisEvent& event) {
+  const uint64_t i = head_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[i & mask_];
+  slot.seq.store(2 * i + 1, std::memory_order_relaxed);
+  // 奇数序号先于事件内容可见，正在读取该槽的消费者据此发现覆盖
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.event = event;
+  slot.seq.store(2 * i + 2, std::memory_order_release);
+  head_.store(i + 1, std::memory_order_release);
+}
+
+AxisEventCursor AxisEventStream::cursor() const {
+  AxisEventCursor cursor;
+  cursor.next = head_.load(std::memory_order_acquire);
+  return cursor;
+}
+
+size_t AxisEventStream::read(AxisEventCursor& cursor, AxisEvent* out, size_t max) const {
+  if (slots_.empty()) return 0;
+  const uint64_t capacity = slots_.size();
+  size_t count = 0;
+  while (count < max) {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    if (cursor.next >= head) break;
+    if (head - cursor.next > capacity) {
+      // 落后超过一圈，跳到仍保存在队列中的最旧事件
+      cursor.lost += head - cursor.next - capacity;
+      cursor.next = head - capacity;
+    }
+
+    // next < head时该槽必已写入过第next个事件，序号不符只能是已被更新的事件覆盖（或正在覆盖）
+    const Slot& slot = slots_[cursor.next & mask_];
+    const uint64_t want = 2 * cursor.next + 2;
+    const bool valid = slot.seq.load(std::memory_order_acquire) == want;
+    const AxisEvent event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (valid && slot.seq.load(std::memory_order_relaxed) == want) {
+      out[count++] = event;
+    } else {
+      ++cursor.lost;
+    }
+    ++cursor.next;
+  }
+  return count;
+}
@@ -0,0 +1,81 @@
+#include "axis_mailbox.hpp"
+#include <sched.h>
+#include <string.h>
+
+AxisMailbox::AxisMailbox() : seq_(0) {}
+
+bool AxisMailbox::reset(size_t axes) {
+  if (!slots_.reset(axes)) return false;
+  AxisFeedback zero;
+  memset(&zero, 0, sizeof(zero));
+  feedback_[0].assign(axes, zero);
+  feedback_[1].assign(axes, zero);
+  seq_.store(0, std::memory_order_release);
+  return true;
+}
+
+AxisFeedback* AxisMailbox::feedback_back() {
+  // 写入的缓冲区可能正被读取上一次之前的发布，上一次publish()须先于本次写入可见
+  std::atomic_thread_fence(std::memory_order_release);
+  return feedback_[(seq_.load(std::memory_order_relaxed) + 1) & 1].data();
+}
+
+void AxisMailbox::publish() { seq_.fetch_add(1, std::memory_order_release); }
+
+AxisFeedback AxisMailbox::feedback(size_t axis) const {
+  AxisFeedback out;
+  memset(&out, 0, sizeof(out));
+  if (axis >= slots_.size()) return out;
+  read([&](const AxisFeedback* all, size_t) { out = all[axis]; });
+  return out;
+}
+
+AxisMailbox::CommandSlot& AxisMailbox::begin_write(size_t axis) {
+  CommandSlot& slot = slots_[axis];
+  for (;;) {
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    if (!(seq & 1) && slot.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire)) break;
+    sched_yield();
+  }
+  // 奇数序号先于命令内容可见，总线线程据此跳过写入中的槽
+  std::atomic_thread_fence(std::memory_order_release);
+  return slot;
+}
+
+void AxisMailbox::end_write(CommandSlot& slot) { slot.seq.fetch_add(1, std::memory_order_release); }
+
+void AxisMailbox::set_control(size_t axis, uint16_t control) {
+  if (axis >= slots_.size()) return;
+  CommandSlot& slot = begin_write(axis);
+  slot.command.control = control;
+  slot.command.fields |= AxisCommand::kControl;
+  end_write(slot);
+}
+
+void AxisMailbox::set_target(size_t axis, int32_t position) {
+  if (axis >= slots_.size()) return;
+  CommandSlot& slot = begin_write(axis);
+  slot.command.target_position = position;
+  slot.command.fields |= AxisCommand::kTarget;
+  end_write(slot);
+}
+
+void AxisMailbox::set_opmode(size_t axis, uint8_t op_mode, uint8_t resv1) {
+  if (axis >= slots_.size()) return;
+  CommandSlot& slot = begin_write(axis);
+  slot.command.op_mode = op_mode;
+  slot.command.resv1 = resv1;
+  slot.command.fields |= AxisCommand::kOpMode;
+  end_write(slot);
+}
+
+bool AxisMailbox::take(size_t axis, AxisCommand& out) {
+  CommandSlot& slot = slots_[axis];
+  const uint32_t seq = slot.seq.load(std::memory_order_acquire);
+  if ((seq & 1) || seq == slot.taken) return false;
+  out = slot.command;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.seq.load(std::memory_order_relaxed) != seq) return false;
+  slot.taken = seq;
+  return true;
+}
@@ -0,0 +1,324 @@
+#include "axis_ops.hpp"
+#include "motor_api.hpp"
+#include "cyclic_runner.hpp"
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/**
+ * @brief 操作类型
+ */
+enum class OpKind : uint8_t {
+  Enable,     ///< 使能（写控制字、目标位置）
+  Move,       ///< 定位（写目标位置）
+  Reset       ///< 故障复位（写控制字）
+};
+
+/**
+ * @brief 操作共享状态
+ *
+ * 令牌与队列各持有一个引用。令牌一方释放最后一个引用时直接删除；
+ * 队列一方（总线线程）释放最后一个引用时放入retired_，由下一次提交删除
+ */
+struct AxisOpState {
+  std::atomic<int> status;      ///< OpStatus，futex等待在此字上
+  std::atomic<int> refs;        ///< 引用计数
+  std::atomic<int> waiters;     ///< 正在等待的线程数，为0时完成操作不做唤醒系统调用
+  std::atomic<bool> cancel;     ///< 取消请求
+  OpKind kind;                  ///< 操作类型
+  bool all_axes;                ///< 作用于全部轴
+  uint64_t mask;                ///< 轴掩码（使能、复位）
+  size_t axis;                  ///< 轴索引（定位）
+  int32_t position;             ///< 终点（定位）
+  MoveOptions move;             ///< 定位选项
+  uint64_t deadline_ns;         ///< 超时时刻
+  bool started;                 ///< 是否已推进过（定位）
+  int64_t commanded;            ///< 当前写出的目标位置（定位）
+  uint64_t touched;             ///< 已发出复位的轴（复位）
+  std::vector<Cia402StateMachine> machines;  ///< 各轴状态机（使能），去抖与复位计数不与回调的make_control()共用
+  AxisOpState* next;            ///< 链表
+
+  AxisOpState(OpKind k, uint32_t timeout_ms)
+      : status(static_cast<int>(OpStatus::Pending)), refs(0), waiters(0), cancel(false), kind(k),
+        all_axes(false), mask(0), axis(0), position(0), started(false), commanded(0), touched(0),
+        next(nullptr) {
+    deadline_ns = CyclicRunner::now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ULL;
+  }
+};
+
+namespace {
+
+int* futex_word(AxisOpState* op) { return reinterpret_cast<int*>(&op->status); }
+
+void release(AxisOpState* op) {
+  if (op->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete op;
+}
+
+/**
+ * @brief 两个操作是否写同一轴的同一对象
+ */
+bool conflicts(const AxisOpState& a, const AxisOpState& b) {
+  if (a.kind == OpKind::Move || b.kind == OpKind::Move) {
+    return a.kind == b.kind && a.axis == b.axis;
+  }
+  return a.all_axes || b.all_axes || (a.mask & b.mask) != 0;
+}
+
+bool in_mask(const AxisOpState& op, size_t m) {
+  if (op.all_axes) return true;
+  return m < kMaxMaskAxes && ((op.mask >> m) & 1u);
+}
+
+} // namespace
+
+AxisOp::AxisOp() : state_(nullptr) {}
+
+AxisOp::AxisOp(AxisOpState* state) : state_(state) {}
+
+AxisOp::AxisOp(const AxisOp& other) : state_(other.state_) {
+  if (state_) state_->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+AxisOp& AxisOp::operator=(const AxisOp& other) {
+  if (other.state_) other.state_->refs.fetch_add(1, std::memory_order_relaxed);
+  if (state_) release(state_);
+  state_ = other.state_;
+  return *this;
+}
+
+AxisOp::~AxisOp() {
+  if (state_) release(state_);
+}
+
+OpStatus AxisOp::status() const {
+  if (!state_) return OpStatus::Failed;
+  return static_cast<OpStatus>(state_->status.load(std::memory_order_acquire));
+}
+
+OpStatus AxisOp::wait(uint32_t timeout_ms) const {
+  if (!state_) return OpStatus::Failed;
+  const uint64_t deadline = CyclicRunner::now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ULL;
+  const int pending = static_cast<int>(OpStatus::Pending);
+
+  state_->waiters.fetch_add(1);
+  while (state_->status.load() == pending) {
+    struct timespec ts;
+    struct timespec* rel = nullptr;
+    if (timeout_ms) {
+      const uint64_t now = CyclicRunner::now_ns();
+      if (now >= deadline) break;
+      ts.tv_sec = static_cast<time_t>((deadline - now) / 1000000000ULL);
+      ts.tv_nsec = static_cast<long>((deadline - now) % 1000000000ULL);
+      rel = &ts;
+    }
+    // 状态已不是pending时立即返回EAGAIN，不会错过唤醒
+    syscall(SYS_futex, futex_word(state_), FUTEX_WAIT_PRIVATE, pending, rel, NULL, 0);
+  }
+  state_->waiters.fetch_sub(1);
+  return status();
+}
+
+void AxisOp::cancel() {
+  if (state_) state_->cancel.store(true, std::memory_order_release);
+}
+
+AxisOpQueue::AxisOpQueue() : incoming_(nullptr), retired_(nullptr), active_(nullptr), active_count_(0) {}
+
+AxisOpQueue::~AxisOpQueue() {
+  // 总线线程已停止，剩余操作以取消结束
+  adopt_incoming();
+  while (active_) {
+    AxisOpState* op = active_;
+    active_ = op->next;
+    finish(op, OpStatus::Cancelled);
+  }
+  reclaim();
+}
+
+AxisOp AxisOpQueue::enable(uint64_t mask, bool all_axes, uint32_t timeout_ms,
+                           std::vector<Cia402StateMachine> machines) {
+  AxisOpState* op = new AxisOpState(OpKind::Enable, timeout_ms);
+  op->mask = mask;
+  op->all_axes = all_axes;
+  op->machines.swap(machines);
+  return submit(op);
+}
+
+AxisOp AxisOpQueue::move(size_t axis, int32_t position, const MoveOptions& options) {
+  AxisOpState* op = new AxisOpState(OpKind::Move, options.timeout_ms);
+  op->axis = axis;
+  op->position = position;
+  op->move = options;
+  return submit(op);
+}
+
+AxisOp AxisOpQueue::reset_faults(uint64_t mask, uint32_t timeout_ms) {
+  AxisOpState* op = new AxisOpState(OpKind::Reset, timeout_ms);
+  op->mask = mask;
+  return submit(op);
+}
+
+AxisOp AxisOpQueue::submit(AxisOpState* op) {
+  reclaim();
+  op->refs.store(2, std::memory_order_relaxed);   // 令牌与队列各一个
+  AxisOpState* head = incoming_.load(std::memory_order_relaxed);
+  do {
+    op->next = head;
+  } while (!incoming_.compare_exchange_weak(head, op, std::memory_order_release, std::memory_order_relaxed));
+  return AxisOp(op);
+}
+
+void AxisOpQueue::reclaim() {
+  AxisOpState* op = retired_.exchange(nullptr, std::memory_order_acquire);
+  while (op) {
+    AxisOpState* next = op->next;
+    delete op;
+    op = next;
+  }
+}
+
+/**
+ * @brief 接收新提交的操作
+ *
+ * 无锁栈取出的顺序与提交相反，逆序后逐个追加到链表尾，并取代与之冲突的旧操作
+ */
+void AxisOpQueue::adopt_incoming() {
+  AxisOpState* batch = incoming_.exchange(nullptr, std::memory_order_acquire);
+  AxisOpState* ordered = nullptr;
+  while (batch) {
+    AxisOpState* next = batch->next;
+    batch->next = ordered;
+    ordered = batch;
+    batch = next;
+  }
+
+  while (ordered) {
+    AxisOpState* op = ordered;
+    ordered = op->next;
+    op->next = nullptr;
+
+    AxisOpState** link = &active_;
+    while (*link) {
+      AxisOpState* old = *link;
+      if (conflicts(*old, *op)) {
+        *link = old->next;
+        --active_count_;
+        finish(old, OpStatus::Cancelled);
+      } else {
+        link = &old->next;
+      }
+    }
+    *link = op;
+    ++active_count_;
+  }
+}
+
+void AxisOpQueue::poll(MotorApi& api) {
+  if (!active_ && !incoming_.load(std::memory_order_relaxed)) return;
+  adopt_incoming();
+
+  const uint64_t now_ns = CyclicRunner::now_ns();
+  AxisOpState** link = &active_;
+  while (*link) {
+    AxisOpState* op = *link;
+    OpStatus result = OpStatus::Cancelled;
+    if (!op->cancel.load(std::memory_order_acquire)) {
+      result = step(*op, api);
+      if (result == OpStatus::Pending && now_ns >= op->deadline_ns) result = OpStatus::TimedOut;
+    }
+
+    if (result == OpStatus::Pending) {
+      link = &op->next;
+      continue;
+    }
+    *link = op->next;
+    --active_count_;
+    finish(op, result);
+  }
+}
+
+/**
+ * @brief 推进一个操作一个周期
+ * @return Done 已达到目标状态，Failed 无法继续，Pending 继续推进
+ */
+OpStatus AxisOpQueue::step(AxisOpState& op, MotorApi& api) {
+  const size_t n = api.motor_count();
+  switch (op.kind) {
+    case OpKind::Enable: {
+      if (op.machines.size() < n) return OpStatus::Failed;   // 提交后轴数量发生变化
+      bool all = true;
+      for (size_t m = 0; m < n; ++m) {
+        if (!in_mask(op, m)) continue;
+        const uint16_t status = api.get_status(m);
+        if ((status & 0x6F) == 0x27) continue;
+        all = false;
+        // 使能前目标位置跟随实际位置，进入操作使能时不出现阶跃
+        api.update_target_pos(m, api.get_actual_pos(m));
+        // 使用操作自己的状态机，回调同周期调用make_control()时轴状态机不会被推进两次
+        bool run_enable = false;
+        api.write_control(m, op.machines[m].step(status, run_enable));
+      }
+      return all ? OpStatus::Done : OpStatus::Pending;
+    }
+
+    case OpKind::Reset: {
+      bool any = false;
+      for (size_t m = 0; m < n && m < kMaxMaskAxes; ++m) {
+        if (!in_mask(op, m)) continue;
+        if (!(api.get_status(m) & 0x0008)) continue;
+        any = true;
+        const uint64_t bit = 1ULL << m;
+        // 复位由0x0080的上升沿触发：先写0，下一周期起保持0x0080
+        api.write_control(m, (op.touched & bit) ? 0x0080 : 0x0000);
+        op.touched |= bit;
+      }
+      if (any) return OpStatus::Pending;
+      for (size_t m = 0; m < n && m < kMaxMaskAxes; ++m) {
+        if (op.touched & (1ULL << m)) api.write_control(m, 0x0000);
+      }
+      return OpStatus::Done;
+    }
+
+    case OpKind::Move: {
+      const uint16_t status = op.axis < n ? api.get_status(op.axis) : 0;
+      if (op.axis >= n || (status & 0x0008) || (status & 0x6F) != 0x27) return OpStatus::Failed;
+      const int64_t actual = api.get_actual_pos(op.axis);
+      if (!op.started) {
+        op.commanded = actual;
+        op.started = true;
+      }
+      int64_t delta = static_cast<int64_t>(op.position) - op.commanded;
+      const int64_t max_step = op.move.max_step;
+      if (max_step > 0) {
+        if (delta > max_step) delta = max_step;
+        if (delta < -max_step) delta = -max_step;
+      }
+      op.commanded += delta;
+      api.update_target_pos(op.axis, static_cast<int32_t>(op.commanded));
+
+      const int64_t error = actual - op.position;
+      const bool reached = op.commanded == op.position && error <= op.move.tolerance && -error <= op.move.tolerance;
+      return reached ? OpStatus::Done : OpStatus::Pending;
+    }
+  }
+  return OpStatus::Failed;
+}
+
+/**
+ * @brief 完成操作：发布状态、唤醒等待方、释放队列的引用
+ */
+void AxisOpQueue::finish(AxisOpState* op, OpStatus status) {
+  op->status.store(static_cast<int>(status));
+  if (op->waiters.load() > 0) {
+    syscall(SYS_futex, futex_word(op), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+  }
+  if (op->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // 令牌已全部销毁；总线线程不释放内存，交给下一次提交
+    AxisOpState* head = retired_.load(std::memory_order_relaxed);
+    do {
+      op->next = head;
+    } while (!retired_.compare_exchange_weak(head, op, std::memory_order_release, std::memory_order_relaxed));
+  }
+}
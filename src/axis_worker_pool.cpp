@@ -0,0 +1,138 @@
+#include "axis_worker_pool.hpp"
+#include "cyclic_runner.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+
+namespace {
+
+// 自旋次数超过该值后每次让出CPU：独占隔离核时sched_yield立即返回，开销很小；
+// 线程多于空闲CPU时避免自旋方占满整个时间片
+const unsigned kSpinsBeforeYield = 2048;
+
+inline void backoff(unsigned& spins) {
+  if (++spins < kSpinsBeforeYield) {
+    cpu_relax();
+  } else {
+    sched_yield();
+  }
+}
+
+} // namespace
+
+AxisWorkerPool::AxisWorkerPool() : generation_(0), fn_(nullptr), count_(0), parts_(1), stop_(false), done_(0) {}
+
+AxisWorkerPool::~AxisWorkerPool() { stop(); }
+
+bool AxisWorkerPool::start(const WorkerPoolConfig& config) {
+  if (!threads_.empty()) return false;
+
+  stop_.store(false);
+  done_.store(0);
+  // 工作线程从代号0开始等待，线程启动晚于首次发布时也不会漏掉任务
+  generation_.store(0);
+  // 先定长分配，线程参数的地址在创建线程后保持不变
+  workers_.resize(config.workers);
+  threads_.reserve(config.workers);
+
+  for (size_t i = 0; i < config.workers; ++i) {
+    workers_[i].pool = this;
+    workers_[i].index = i;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (i < config.cpus.size() && config.cpus[i] >= 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(config.cpus[i], &set);
+      pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+    if (config.priority > 0) {
+      struct sched_param param;
+      memset(&param, 0, sizeof(param));
+      param.sched_priority = config.priority;
+      pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+      pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+      pthread_attr_setschedparam(&attr, &param);
+    }
+
+    pthread_t thread;
+    SigintBlockScope sigint;
+    int rc = pthread_create(&thread, &attr, &AxisWorkerPool::thread_entry, &workers_[i]);
+    if (rc == EPERM && config.priority > 0) {
+      if (i == 0) printf("Worker pool: SCHED_FIFO priority %d not permitted, using default policy\n", config.priority);
+      pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+      rc = pthread_create(&thread, &attr, &AxisWorkerPool::thread_entry, &workers_[i]);
+    }
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+      printf("Worker pool: failed to create worker %zu: %s\n", i, strerror(rc));
+      stop();
+      return false;
+    }
+    threads_.push_back(thread);
+  }
+  parts_ = threads_.size() + 1;
+  return true;
+}
+
+void AxisWorkerPool::stop() {
+  if (threads_.empty()) return;
+  stop_.store(true, std::memory_order_release);
+  generation_.fetch_add(1, std::memory_order_release);
+  for (pthread_t thread : threads_) pthread_join(thread, NULL);
+  threads_.clear();
+  workers_.clear();
+  parts_ = 1;
+}
+
+/**
+ * @brief 计算第part块的区间，块0归主线程
+ */
+void AxisWorkerPool::range_of(size_t part, size_t& begin, size_t& end) const {
+  begin = count_ * part / parts_;
+  end = count_ * (part + 1) / parts_;
+}
+
+void AxisWorkerPool::run(size_t count, const RangeFn& fn) {
+  if (threads_.empty() || count <= 1) {
+    fn(0, count);
+    return;
+  }
+
+  fn_ = &fn;
+  count_ = count;
+  done_.store(0, std::memory_order_relaxed);
+  generation_.fetch_add(1, std::memory_order_release);
+
+  size_t begin, end;
+  range_of(0, begin, end);
+  if (begin < end) fn(begin, end);
+
+  const size_t workers = threads_.size();
+  unsigned spins = 0;
+  while (done_.load(std::memory_order_acquire) != workers) backoff(spins);
+}
+
+void* AxisWorkerPool::thread_entry(void* arg) {
+  Worker* worker = static_cast<Worker*>(arg);
+  worker->pool->worker_loop(worker->index);
+  return NULL;
+}
+
+void AxisWorkerPool::worker_loop(size_t index) {
+  uint64_t seen = 0;
+  for (;;) {
+    uint64_t gen;
+    unsigned spins = 0;
+    while ((gen = generation_.load(std::memory_order_acquire)) == seen) backoff(spins);
+    seen = gen;
+    if (stop_.load(std::memory_order_acquire)) break;
+
+    size_t begin, end;
+    range_of(index + 1, begin, end);
+    if (begin < end) (*fn_)(begin, end);
+    done_.fetch_add(1, std::memory_order_release);
+  }
+}
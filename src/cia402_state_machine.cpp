@@ -0,0 +1,51 @@
+#include "cia402_state_machine.hpp"
+
+Cia402Table::Cia402Table()
+    : settle_cycles(0), fault_reset_limit(0), fault_escape_control(0x0006),
+      row_count_(0), override_count_(0) {
+    for (const auto& row : kCia402StandardTable) {
+        rows_[row_count_++] = row;
+    }
+    rebuild();
+}
+
+bool Cia402Table::patch(const Cia402Transition& row) {
+    if (row.mask & ~0x007F) {
+        // 涉及高位的补丁无法展开到查找表，按插入的逆序优先匹配
+        if (override_count_ >= kMaxOverrides) return false;
+        for (size_t i = override_count_; i > 0; --i) {
+            overrides_[i] = overrides_[i - 1];
+        }
+        overrides_[0] = row;
+        ++override_count_;
+        return true;
+    }
+
+    if (row_count_ >= kMaxRows) return false;
+    for (size_t i = row_count_; i > 0; --i) {
+        rows_[i] = rows_[i - 1];
+    }
+    rows_[0] = row;
+    ++row_count_;
+    rebuild();
+    return true;
+}
+
+const Cia402Table& Cia402Table::standard() {
+    static const Cia402Table table;
+    return table;
+}
+
+void Cia402Table::rebuild() {
+    rows_[row_count_] = kCia402Fallback;
+    for (uint16_t key = 0; key < 128; ++key) {
+        size_t hit = row_count_;
+        for (size_t i = 0; i < row_count_; ++i) {
+            if ((key & rows_[i].mask) == rows_[i].value) {
+                hit = i;
+                break;
+            }
+        }
+        lut_[key] = static_cast<uint8_t>(hit);
+    }
+}
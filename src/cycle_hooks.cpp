@@ -0,0 +1,68 @@
+#include "cycle_hooks.hpp"
+#include "cyclic_runner.hpp"
+#include <stdio.h>
+
+void CycleHooks::add(HookPhase phase, const std::string& name, const Hook& hook, int order) {
+  Entry entry;
+  entry.info.name = name;
+  entry.info.phase = phase;
+  entry.info.order = order;
+  entry.info.runs = 0;
+  entry.info.last_ns = 0;
+  entry.fn = hook;
+  entry.timing.reset(new LatencyHistogram);
+
+  // 插在同序号钩子之后，相同序号保持注册顺序
+  std::vector<Entry>& hooks = hooks_[index_of(phase)];
+  size_t pos = hooks.size();
+  while (pos > 0 && hooks[pos - 1].info.order > order) --pos;
+  hooks.insert(hooks.begin() + pos, std::move(entry));
+}
+
+void CycleHooks::clear() {
+  for (size_t p = 0; p < kPhases; ++p) hooks_[p].clear();
+}
+
+bool CycleHooks::run(HookPhase phase, MotorApi& api, uint64_t cycle) {
+  for (auto& entry : hooks_[index_of(phase)]) {
+    const uint64_t start = CyclicRunner::now_ns();
+    const bool keep = entry.fn(api, cycle);
+    entry.info.last_ns = CyclicRunner::now_ns() - start;
+    entry.timing->record(entry.info.last_ns);
+    ++entry.info.runs;
+    if (!keep) {
+      printf("CycleHooks: %s hook '%s' ended the loop\n", phase_name(phase), entry.info.name.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+void CycleHooks::reset_timing() {
+  for (size_t p = 0; p < kPhases; ++p) {
+    for (auto& entry : hooks_[p]) entry.timing->reset();
+  }
+}
+
+void CycleHooks::print_timing() const {
+  for (size_t p = 0; p < kPhases; ++p) {
+    for (const auto& entry : hooks_[p]) {
+      HistogramSummary h = entry.timing->summary();
+      printf("  %-12s %-20s n=%llu p50=%llu p99=%llu max=%llu ns\n", phase_name(entry.info.phase),
+             entry.info.name.c_str(), (unsigned long long)h.count, (unsigned long long)h.p50,
+             (unsigned long long)h.p99, (unsigned long long)h.max);
+    }
+  }
+}
+
+const char* CycleHooks::phase_name(HookPhase phase) {
+  switch (phase) {
+    case HookPhase::PreReceive:
+      return "pre-receive";
+    case HookPhase::PostProcess:
+      return "post-process";
+    case HookPhase::PreSend:
+      return "pre-send";
+  }
+  return "unknown";
+}
@@ -0,0 +1,124 @@
+#include "cycle_watchdog.hpp"
+#include "cyclic_runner.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+
+CycleWatchdog::CycleWatchdog()
+    : running_(false), stop_(false), armed_(false), last_beat_ns_(0), beats_(0), stalled_(false), max_gap_ns_(0),
+      stalls_(0) {}
+
+CycleWatchdog::~CycleWatchdog() { stop(); }
+
+bool CycleWatchdog::start(const WatchdogConfig& config, const StallHandler& handler) {
+  if (running_) return false;
+
+  config_ = config;
+  if (config_.check_period_us == 0) config_.check_period_us = 1000;
+  if (config_.stall_timeout_us < config_.check_period_us) config_.stall_timeout_us = config_.check_period_us;
+  handler_ = handler;
+  stop_.store(false);
+  stalled_.store(false);
+  max_gap_ns_.store(0);
+  stalls_.store(0);
+  stall_durations_.reset();
+  last_beat_ns_.store(CyclicRunner::now_ns());
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  if (config_.cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(config_.cpu, &set);
+    pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+  }
+  if (config_.priority > 0) {
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = config_.priority;
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+  }
+
+  SigintBlockScope sigint;
+  int rc = pthread_create(&thread_, &attr, &CycleWatchdog::thread_entry, this);
+  if (rc == EPERM && config_.priority > 0) {
+    printf("Watchdog: SCHED_FIFO priority %d not permitted, using default policy\n", config_.priority);
+    pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+    rc = pthread_create(&thread_, &attr, &CycleWatchdog::thread_entry, this);
+  }
+  pthread_attr_destroy(&attr);
+  if (rc != 0) {
+    printf("Watchdog: failed to create thread: %s\n", strerror(rc));
+    return false;
+  }
+
+  running_ = true;
+  return true;
+}
+
+void CycleWatchdog::stop() {
+  if (!running_) return;
+  stop_.store(true);
+  pthread_join(thread_, NULL);
+  running_ = false;
+}
+
+void CycleWatchdog::arm(uint64_t now_ns) {
+  // 上一次撤防时未恢复的停滞不再计时，从本次布防重新开始
+  last_beat_ns_.store(now_ns, std::memory_order_release);
+  stalled_.store(false, std::memory_order_release);
+  armed_.store(true, std::memory_order_release);
+}
+
+void* CycleWatchdog::thread_entry(void* arg) {
+  static_cast<CycleWatchdog*>(arg)->run();
+  return NULL;
+}
+
+/**
+ * @brief 监督循环
+ *
+ * 布防期间每个检查周期比较心跳时间与当前时间；间隔超过时限进入停滞并调用处理函数，
+ * 心跳恢复后把本次停滞的时长记入直方图。未布防时只睡眠
+ */
+void CycleWatchdog::run() {
+  const uint64_t period_ns = static_cast<uint64_t>(config_.check_period_us) * 1000ULL;
+  const uint64_t timeout_ns = static_cast<uint64_t>(config_.stall_timeout_us) * 1000ULL;
+  uint64_t stall_start = 0;
+  uint64_t stall_beats = 0;
+
+  while (!stop_.load(std::memory_order_relaxed)) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(period_ns / 1000000000ULL);
+    ts.tv_nsec = static_cast<long>(period_ns % 1000000000ULL);
+    nanosleep(&ts, NULL);
+    if (!armed_.load(std::memory_order_acquire)) continue;
+
+    const uint64_t last = last_beat_ns_.load(std::memory_order_acquire);
+    const uint64_t now = CyclicRunner::now_ns();
+    const uint64_t gap = now > last ? now - last : 0;
+    if (gap > max_gap_ns_.load(std::memory_order_relaxed)) max_gap_ns_.store(gap, std::memory_order_relaxed);
+
+    if (stalled_.load(std::memory_order_relaxed)) {
+      if (beats() != stall_beats) {
+        // 心跳已恢复：停滞时长为停滞起点到恢复后第一次心跳
+        stall_durations_.record(last - stall_start);
+        printf("Watchdog: cyclic loop resumed after %.3f ms\n", (last - stall_start) / 1e6);
+        stalled_.store(false, std::memory_order_release);
+      } else {
+        if (handler_) handler_(gap, false);
+      }
+    } else if (gap > timeout_ns) {
+      stall_start = last;
+      stall_beats = beats();
+      stalled_.store(true, std::memory_order_release);
+      stalls_.fetch_add(1, std::memory_order_relaxed);
+      printf("Watchdog: no heartbeat for %.3f ms (timeout %.3f ms)\n", gap / 1e6, timeout_ns / 1e6);
+      if (handler_) handler_(gap, true);
+    }
+  }
+}
@@ -0,0 +1,139 @@
+#include "cyclic_runner.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+namespace {
+
+const uint64_t kNsPerSec = 1000000000ULL;
+
+void to_timespec(uint64_t ns, struct timespec* ts) {
+  ts->tv_sec = static_cast<time_t>(ns / kNsPerSec);
+  ts->tv_nsec = static_cast<long>(ns % kNsPerSec);
+}
+
+/**
+ * @brief 预触碰栈空间，避免周期内首次访问栈页产生缺页
+ */
+void prefault_stack(size_t bytes) {
+  const size_t kChunk = 4096;
+  unsigned char buf[kChunk];
+  memset(buf, 0, sizeof(buf));
+  if (bytes > kChunk) prefault_stack(bytes - kChunk);
+  // 防止编译器优化掉memset
+  __asm__ __volatile__("" : : "r"(buf) : "memory");
+}
+
+} // namespace
+
+CyclicRunner::CyclicRunner(const RtConfig& config)
+    : config_(config), deadline_(0), cycle_start_(0), cycles_(0), missed_(0), overruns_(0),
+      consecutive_overruns_(0) {
+  if (config_.period_ns == 0) config_.period_ns = 1000000;
+  if (config_.spin_margin_ns > config_.period_ns) config_.spin_margin_ns = config_.period_ns;
+  if (config_.send_offset_ns >= config_.period_ns) config_.send_offset_ns = 0;
+}
+
+bool CyclicRunner::apply_realtime() {
+  bool ok = true;
+
+  if (config_.lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    printf("mlockall failed: %s\n", strerror(errno));
+    ok = false;
+  }
+
+  if (config_.prefault_stack) {
+    prefault_stack(config_.prefault_stack);
+  }
+
+  if (config_.cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(config_.cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+      printf("Failed to bind to CPU %d: %s\n", config_.cpu, strerror(rc));
+      ok = false;
+    }
+  }
+
+  if (config_.priority > 0) {
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = config_.priority;
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0) {
+      printf("Failed to set SCHED_FIFO priority %d: %s\n", config_.priority, strerror(rc));
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+void CyclicRunner::start() {
+  cycle_start_ = now_ns();
+  deadline_ = cycle_start_ + config_.period_ns;
+  cycles_ = 0;
+  missed_ = 0;
+  overruns_ = 0;
+  consecutive_overruns_ = 0;
+}
+
+void CyclicRunner::wait_next() {
+  // 进入等待时已过截止时间：上一周期的工作超时
+  bool late = now_ns() > deadline_;
+  wait_until(deadline_);
+
+  ++cycles_;
+  cycle_start_ = deadline_;
+  deadline_ += config_.period_ns;
+
+  // 已错过下一截止时间时按整周期跳过，保持相位
+  uint64_t now = now_ns();
+  if (now >= deadline_) {
+    uint64_t skip = (now - deadline_) / config_.period_ns + 1;
+    deadline_ += skip * config_.period_ns;
+    missed_ += skip;
+    late = true;
+  }
+
+  if (late) {
+    ++overruns_;
+    ++consecutive_overruns_;
+  } else {
+    consecutive_overruns_ = 0;
+  }
+}
+
+void CyclicRunner::wait_until(uint64_t abs_ns) const {
+  const uint64_t margin = config_.spin_margin_ns;
+  if (abs_ns > margin) {
+    struct timespec ts;
+    to_timespec(abs_ns - margin, &ts);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+  }
+  if (margin) {
+    while (now_ns() < abs_ns) cpu_relax();
+  }
+}
+
+uint64_t CyclicRunner::now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * kNsPerSec + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+SigintBlockScope::SigintBlockScope() {
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGINT);
+  pthread_sigmask(SIG_BLOCK, &set, &saved_);
+}
+
+SigintBlockScope::~SigintBlockScope() { pthread_sigmask(SIG_SETMASK, &saved_, NULL); }
@@ -29,6 +29,29 @@ void MotorAdapterManager::clear() {
     adapters_.clear();
 }
 
+// MotorAdapter批处理默认实现：逐轴调用单轴虚函数
+void MotorAdapter::decodeBatch(const uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                               size_t count, MotorStatus* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = readStatus(domain_pd, *offsets[i]);
+    }
+}
+
+void MotorAdapter::encodeBatch(uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                               size_t count, const MotorControl* in) const {
+    for (size_t i = 0; i < count; ++i) {
+        writeControl(domain_pd, *offsets[i], in[i]);
+    }
+}
+
+void MotorAdapter::makeControlBatch(const uint16_t* status, size_t count,
+                                    uint16_t* control, bool* run_enable) const {
+    for (size_t i = 0; i < count; ++i) {
+        int32_t start_pos = 0;
+        control[i] = makeControl(status[i], start_pos, run_enable[i]);
+    }
+}
+
 // StandardMotorAdapter实现
 MotorAdapter::MotorInfo StandardMotorAdapter::getMotorInfo() const {
     return {
@@ -43,97 +66,73 @@ MotorAdapter::MotorInfo StandardMotorAdapter::getMotorInfo() const {
 }
 
 bool StandardMotorAdapter::configurePdo(ec_slave_config_t* slave_config) {
-    // 标准CiA 402 PDO配置
-    static ec_pdo_entry_info_t slave_pdo_entries[] = {
-        {0x6040, 0x00, 16}, // Control word
-        {0x607A, 0x00, 32}, // Target position
-        {0x60FF, 0x00, 32}, // Target velocity
-        {0x6071, 0x00, 16}, // Target torque
-        {0x6060, 0x00, 8},  // Operation mode
-        {0x60C2, 0x00, 8},  // Reserved 1
-        {0x6041, 0x00, 16}, // Status word
-        {0x6064, 0x00, 32}, // Actual position
-        {0x606C, 0x00, 32}, // Actual velocity
-        {0x6077, 0x00, 16}, // Actual torque
-        {0x6061, 0x00, 8},  // Operation mode display
-        {0x603F, 0x00, 16}, // Error code
-        {0x2026, 0x00, 8},  // Reserved 2
-    };
-
-    static ec_pdo_info_t slave_rx_pdo[] = {
-        {0x1600, 6, slave_pdo_entries},
-    };
-
-    static ec_pdo_info_t slave_tx_pdo[] = {
-        {0x1A00, 7, &slave_pdo_entries[6]},
-    };
-
-    static ec_sync_info_t slave_syncs[] = {
-        {0, EC_DIR_OUTPUT, 0, NULL, EC_WD_DISABLE},
-        {1, EC_DIR_INPUT, 0, NULL, EC_WD_DISABLE},
-        {2, EC_DIR_OUTPUT, 1, slave_rx_pdo, EC_WD_ENABLE},
-        {3, EC_DIR_INPUT, 1, slave_tx_pdo, EC_WD_DISABLE},
-        {0xff}
-    };
-
-    return ecrt_slave_config_pdos(slave_config, EC_END, slave_syncs) == 0;
+    // 标准CiA 402 PDO配置，由RxLayout/TxLayout生成
+    return Mapping::configure(slave_config);
 }
 
 std::vector<MotorAdapter::PdoConfig> StandardMotorAdapter::getRxPdoConfig() const {
-    return {
-        {0x6040, 0x00, 16}, // Control word
-        {0x607A, 0x00, 32}, // Target position
-        {0x60FF, 0x00, 32}, // Target velocity
-        {0x6071, 0x00, 16}, // Target torque
-        {0x6060, 0x00, 8},  // Operation mode
-        {0x0000, 0x00, 0},  // Gap (填充)
-        {0x0000, 0x00, 0},  // Gap (填充)
-        {0x0000, 0x00, 0},  // Gap (填充)
-        {0x0000, 0x00, 0},  // Gap (填充)
-        {0x0000, 0x00, 0}   // Gap (填充)
-    };
+    std::vector<PdoConfig> configs(RxLayout::size);
+    for (size_t i = 0; i < RxLayout::size; ++i) {
+        configs[i].index = RxLayout::entries[i].index;
+        configs[i].subindex = RxLayout::entries[i].subindex;
+        configs[i].bit_length = RxLayout::entries[i].bit_length;
+    }
+    return configs;
 }
 
 std::vector<MotorAdapter::PdoConfig> StandardMotorAdapter::getTxPdoConfig() const {
-    return {
-        {0x6041, 0x00, 16}, // Status word
-        {0x6064, 0x00, 32}, // Actual position
-        {0x606C, 0x00, 32}, // Actual velocity
-        {0x6077, 0x00, 16}, // Actual torque
-        {0x6061, 0x00, 8},  // Operation mode display
-        {0x603F, 0x00, 16}, // Error code
-        {0x0000, 0x00, 0},  // Gap (填充)
-        {0x0000, 0x00, 0},  // Gap (填充)
-        {0x0000, 0x00, 0},  // Gap (填充)
-        {0x0000, 0x00, 0}   // Gap (填充)
-    };
+    std::vector<PdoConfig> configs(TxLayout::size);
+    for (size_t i = 0; i < TxLayout::size; ++i) {
+        configs[i].index = TxLayout::entries[i].index;
+        configs[i].subindex = TxLayout::entries[i].subindex;
+        configs[i].bit_length = TxLayout::entries[i].bit_length;
+    }
+    return configs;
 }
 
 MotorAdapter::MotorStatus StandardMotorAdapter::readStatus(const uint8_t* domain_pd, 
                                                           const std::vector<unsigned int>& offset) const {
-    MotorStatus status = {};
-    
-    if (offset.size() >= 10) {
-        status.status_word = readInt16(domain_pd + offset[0]);
-        status.actual_position = readInt32(domain_pd + offset[1]);
-        status.actual_velocity = readInt32(domain_pd + offset[2]);
-        status.actual_torque = readInt16(domain_pd + offset[3]);
-        status.operation_mode = *(domain_pd + offset[4]);
-        status.error_code = readInt16(domain_pd + offset[5]);
+    if (offset.size() < RxLayout::size + TxLayout::size) {
+        return MotorStatus();
     }
-    
-    return status;
+    return decodeStatus(domain_pd, offset.data() + RxLayout::size);
 }
 
 void StandardMotorAdapter::writeControl(uint8_t* domain_pd, const std::vector<unsigned int>& offset, 
                                       const MotorControl& control) const {
-    if (offset.size() >= 10) {
-        writeInt16(domain_pd + offset[0], control.control_word);
-        writeInt32(domain_pd + offset[1], control.target_position);
-        writeInt32(domain_pd + offset[2], control.target_velocity);
-        writeInt16(domain_pd + offset[3], control.target_torque);
-        *(domain_pd + offset[4]) = control.operation_mode;
-        // 剩余的6个偏移量用于Gap填充，不需要写入数据
+    if (offset.size() >= RxLayout::size + TxLayout::size) {
+        encodeControl(domain_pd, offset.data(), control);
+    }
+}
+
+void StandardMotorAdapter::decodeBatch(const uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                                       size_t count, MotorStatus* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        const std::vector<unsigned int>& offset = *offsets[i];
+        out[i] = offset.size() >= RxLayout::size + TxLayout::size
+                     ? decodeStatus(domain_pd, offset.data() + RxLayout::size)
+                     : MotorStatus();
+    }
+}
+
+void StandardMotorAdapter::encodeBatch(uint8_t* domain_pd, const std::vector<unsigned int>* const* offsets,
+                                       size_t count, const MotorControl* in) const {
+    for (size_t i = 0; i < count; ++i) {
+        const std::vector<unsigned int>& offset = *offsets[i];
+        if (offset.size() >= RxLayout::size + TxLayout::size) {
+            encodeControl(domain_pd, offset.data(), in[i]);
+        }
+    }
+}
+
+void StandardMotorAdapter::makeControlBatch(const uint16_t* status, size_t count,
+                                            uint16_t* control, bool* run_enable) const {
+    // 转换表只取一次，循环内为内联查表
+    const Cia402Table& table = stateTable();
+    for (size_t i = 0; i < count; ++i) {
+        const Cia402Transition& t = table.lookup(status[i]);
+        control[i] = t.control;
+        run_enable[i] = (t.flags & kCia402RunEnable) != 0;
     }
 }
 
@@ -171,58 +170,15 @@ std::string StandardMotorAdapter::getName() const {
 }
 
 uint16_t StandardMotorAdapter::makeControl(uint16_t status, int32_t &start_pos, bool &run_enable) const {
-  uint16_t control = 0;
-  
-  // 解析状态字的关键位
-  bool ready_to_switch_on = (status & 0x0001) != 0;
-  bool switched_on = (status & 0x0002) != 0; 
-  bool operation_enabled = (status & 0x0004) != 0;
-  bool fault = (status & 0x0008) != 0;
-  bool voltage_enabled = (status & 0x0010) != 0;
-  bool quick_stop = (status & 0x0020) != 0;
-  bool switch_on_disabled = (status & 0x0040) != 0;
-  bool warning = (status & 0x0080) != 0;
-  
-  // 更智能的状态机处理 - 严格按照CiA 402标准
-  if (fault) {
-    // 故障状态 - 复位故障
-    control = 0x0080; // 故障复位
-    run_enable = false;
-  } else if (warning) {
-    // 警告状态 - 先尝试清除警告，然后正常启动流程
-    control = 0x0006; // 准备开启
-    run_enable = true;
-  } else if (switch_on_disabled) {
-    // 开关被禁用 - 清除禁用状态
-    control = 0x06; // 开启使能（清除禁用）
-    run_enable = true; // 准备下一步启用操作
-  } else if (quick_stop) {
-    // 快速停止状态 - 先禁用快速停止
-    control = 0x02; // 禁用快速停止
-    run_enable = true; // 准备下一步启用操作
-  } else if (!ready_to_switch_on && !switched_on) {
-    // 完全关闭状态 - 准备开启
-    control = 0x06; // 开启
-    run_enable = true;
-  } else if (ready_to_switch_on && !switched_on) {
-    // 准备好但未开启 - 开启
-    control = 0x07; // 开启操作
-    run_enable = true;
-  } else if (ready_to_switch_on && switched_on && !operation_enabled) {
-    // 关键状态：已准备好且已开启，但操作未启用
-    control = 0x0F; // 启用操作（这是关键！）
-    run_enable = true;
-  } else if (operation_enabled) {
-    // 操作已启用 - 保持运行状态
-    control = 0x0F; // 保持操作
-    run_enable = true;
-  } else {
-    // 默认情况 - 尝试启用操作
-    control = 0x06; // 准备开启
-    run_enable = true;
-  }
-  
-  return control;
+  (void)start_pos;
+  // 无状态查表：不做去抖与故障计数，需要这些行为时使用Cia402StateMachine
+  const Cia402Transition& t = stateTable().lookup(status);
+  run_enable = (t.flags & kCia402RunEnable) != 0;
+  return t.control;
+}
+
+const Cia402Table& StandardMotorAdapter::stateTable() const {
+  return Cia402Table::standard();
 }
 
 // 工具函数实现
@@ -17,6 +17,7 @@
 #include <signal.h>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include "motor_api.hpp"
@@ -260,115 +261,45 @@ private:
 };
 
 /**
- * @brief PDO条目索引枚举
- * 定义了EtherCAT从站中各个PDO条目的索引
+ * @brief 全局活动API指针
+ * 用于信号处理函数访问当前活动的MotorApi实例
  */
-enum {
-    CONTROL_WORD = 0,      ///< 控制字索引 (0x6040)
-    TARGET_POS,              ///< 目标位置索引 (0x607A)
-    TARGET_VELOCITY,         ///< 目标速度索引 (0x60FF)
-    TARGET_TOR,              ///< 目标力矩索引 (0x6071)
-    OP_MODE,                 ///< 操作模式索引 (0x6060)
-    RESV1,                   ///< 保留参数1索引 (0x60C2)
-    STATUS_WORD,             ///< 状态字索引 (0x6041)
-    ACTUAL_POS,              ///< 实际位置索引 (0x6064)
-    ACTUAL_VELOCITY,         ///< 实际速度索引 (0x606C)
-    ACTUAN_TOR,              ///< 实际力矩索引 (0x6077)
-    OP_MODE_DIS,             ///< 操作模式显示索引 (0x6061)
-    RESV2,                   ///< 保留参数2索引 (0x2026)
-    NUM_ENTRIES              ///< 条目总数
-};
+static std::atomic<MotorApi*> g_active_api(nullptr);
 
-/**
- * @brief PDO条目信息定义
- * 定义了从站中各个PDO条目的COB-ID、子索引和位长度
- */
-static ec_pdo_entry_info_t slave_pdo_entries[] = {
-    {0x6040, 0x00, 16}, // Control word
-    {0x607A, 0x00, 32}, // Target pos
-    {0x60FF, 0x00, 32}, // Target velocity
-    {0x6071, 0x00, 16}, // Target tor
-    {0x6060, 0x00, 8},  // Operation mode
-    {0x60C2, 0x00, 8},  // Reserved 1
-
-    {0x6041, 0x00, 16}, // Status word
-    {0x6064, 0x00, 32}, // Actual pos
-    {0x606C, 0x00, 32}, // Actual velocity
-    {0x6077, 0x00, 16}, // Actual tor
-    {0x6061, 0x00, 8},  // Operation mode display
-    {0x603F, 0x00, 16}, // Error code
-    {0x2026, 0x00, 8},  // Reserved 2
-};
+namespace {
 
 /**
- * @brief RxPDO定义
- * 定义接收PDO映射，包含6个控制相关条目
+ * @brief 当前线程持有总线的MotorApi实例
+ *
+ * 线程模式下，内部线程、其工作线程和接管总线的看门狗在此登记，
+ * 读写函数据此区分直接访问域数据还是经交换区访问
  */
-static ec_pdo_info_t slave_rx_pdo[] = {
-    {0x1600, 6, slave_pdo_entries},
-};
+thread_local const MotorApi *t_bus_api = nullptr;
 
 /**
- * @brief TxPDO定义
- * 定义发送PDO映射，包含7个状态相关条目
+ * @brief 在作用域内将当前线程登记为总线线程
  */
-static ec_pdo_info_t slave_tx_pdo[] = {
-    {0x1A00, 7, &slave_pdo_entries[6]},
-};
+class BusThreadScope {
+public:
+  explicit BusThreadScope(const MotorApi *api) : prev_(t_bus_api) { t_bus_api = api; }
+  ~BusThreadScope() { t_bus_api = prev_; }
 
-/**
- * @brief 同步管理器配置
- * 定义EtherCAT同步管理器的配置参数
- */
-const static ec_sync_info_t slave_syncs[] = {
-    {0, EC_DIR_OUTPUT, 0, NULL, EC_WD_DISABLE},    ///< SM0: 输出，无PDO，看门狗禁用
-    {1, EC_DIR_INPUT, 0, NULL, EC_WD_DISABLE},       ///< SM1: 输入，无PDO，看门狗禁用
-    {2, EC_DIR_OUTPUT, 1, slave_rx_pdo, EC_WD_ENABLE}, ///< SM2: 输出，RxPDO，看门狗启用
-    {3, EC_DIR_INPUT, 1, slave_tx_pdo, EC_WD_DISABLE}, ///< SM3: 输入，TxPDO，看门狗禁用
-    {0xff}  ///< 结束标记
+private:
+  const MotorApi *prev_;
 };
 
-/**
- * @brief 小端32位整数读取函数
- * @param data 字节数据指针
- * @return 转换后的32位整数
- * 
- * 将从站的小端格式数据转换为本地32位整数
- */
-int32_t read_le_int32(uint8_t *data)
-{
-  return static_cast<int32_t>(
-    (data[0]) |
-    (data[1] << 8) |
-    (data[2] << 16) |
-    (data[3] << 24));
-}
-
-/**
- * @brief 小端16位整数读取函数
- * @param data 字节数据指针
- * @return 转换后的16位整数
- * 
- * 将从站的小端格式数据转换为本地16位整数
- */
-int16_t read_le_int16(const uint8_t *data) {
-  return static_cast<int16_t>(
-    (data[0]) |
-    (data[1] << 8));
-}
-
-/**
- * @brief 全局活动API指针
- * 用于信号处理函数访问当前活动的MotorApi实例
- */
-static MotorApi *g_active_api = nullptr;
+} // namespace
 
 /**
  * @brief 构造函数
  * 初始化所有成员变量为默认值，注册默认的电机适配器
  */
 MotorApi::MotorApi()
-  : master_(nullptr), domain_(nullptr), domain_pd_(nullptr), slave_count_(0), run_(true) {
+  : master_(nullptr), domain_(nullptr), domain_pd_(nullptr), slave_count_(0),
+    snapshot_enabled_(false), last_rx_start_ns_(0), rx_end_ns_(0), overruns_(0),
+    overrun_tripped_(false), bus_owner_(kBusFree), bus_held_(false), watchdog_tripped_(false),
+    snapshot_seq_(0), stream_count_(0), threaded_(false), thread_stop_(false), bus_thread_(),
+    run_(true) {
   // 注册默认的电机适配器
   auto& manager = MotorAdapterManager::getInstance();
   manager.registerAdapter(std::make_shared<EyouMotorAdapter>());
@@ -721,6 +652,11 @@ bool MotorApi::init_auto() {
     return false;
   }
   
+  // 解析PDO槽位表，周期内的访问函数只使用该表
+  build_pdo_slots();
+  build_state_machines();
+  build_adapter_groups();
+  
   printf("Detected %zu motor slaves\n", slave_count_);
   
   if (slave_count_ == 0) {
@@ -777,18 +713,6 @@ bool MotorApi::init_from_eni(const char* eni_filename) {
   
   printf("Configuring slaves from ENI file...\n");
   
-  // 定义支持的从站类型列表（可以从ENI文件扩展）
-  struct SupportedSlave {
-    uint32_t vendor_id;
-    uint32_t product_code;
-    const char* name;
-    bool (*config_func)(ec_slave_config_t* cfg);
-  };
-  
-  auto config_standard_pdo = [](ec_slave_config_t* cfg) -> bool {
-    return ecrt_slave_config_pdos(cfg, EC_END, slave_syncs) == 0;
-  };
-  
   // 获取电机适配器管理器
   auto& adapter_manager = MotorAdapterManager::getInstance();
   
@@ -894,6 +818,11 @@ bool MotorApi::init_from_eni(const char* eni_filename) {
     return false;
   }
   
+  // 解析PDO槽位表，周期内的访问函数只使用该表
+  build_pdo_slots();
+  build_state_machines();
+  build_adapter_groups();
+  
   printf("Detected %zu ENI motor slaves\n", slave_count_);
   
   printf("EtherCAT initialization from ENI file completed successfully\n");
@@ -905,8 +834,124 @@ bool MotorApi::init_from_eni(const char* eni_filename) {
  * 从主站接收数据并处理域数据
  */
 void MotorApi::receive_and_process() {
+  if (via_mailbox()) return;
+  if (!bus_held_ && !claim_bus()) return;
+  
+  const uint64_t start = CyclicRunner::now_ns();
+  if (last_rx_start_ns_) cycle_stats_.period.record(start - last_rx_start_ns_);
+  last_rx_start_ns_ = start;
+  
   ecrt_master_receive(master_);
   ecrt_domain_process(domain_);
+  
+  if (snapshot_enabled_) {
+    decode_snapshot();
+  } else {
+    gather_status_words();
+  }
+  compute_status_masks(snapshot_.status_word.data(), snapshot_.size(), status_masks_);
+  
+  rx_end_ns_ = CyclicRunner::now_ns();
+  if (events_.enabled()) {
+    events_.detect(snapshot_seq_.load(std::memory_order_relaxed) + 1, rx_end_ns_, snapshot_.status_word.data(),
+                   snapshot_.mode_display.data(), snapshot_.error_code.data());
+  }
+  cycle_stats_.receive.record(rx_end_ns_ - start);
+  snapshot_seq_.fetch_add(1, std::memory_order_release);
+}
+
+void MotorApi::set_snapshot_enabled(bool enabled) { snapshot_enabled_ = enabled; }
+
+bool MotorApi::snapshot_enabled() const { return snapshot_enabled_; }
+
+const AxisSnapshot& MotorApi::snapshot() const { return snapshot_; }
+
+StatusMasks MotorApi::status_masks() const { return via_mailbox() ? published_masks() : status_masks_; }
+
+/**
+ * @brief 由交换区最近一次发布的状态字计算全轴状态掩码
+ * 
+ * 总线线程每周期重写status_masks_，应用线程改为从同一次完整发布的状态字重新计算
+ */
+StatusMasks MotorApi::published_masks() const {
+  StatusMasks masks;
+  mailbox_.read([&masks](const AxisFeedback* all, size_t n) {
+    uint16_t status[kMaxMaskAxes];
+    if (n > kMaxMaskAxes) n = kMaxMaskAxes;
+    for (size_t m = 0; m < n; ++m) status[m] = all[m].status_word;
+    compute_status_masks(status, n, masks);
+  });
+  return masks;
+}
+
+bool MotorApi::enable_events(size_t capacity, uint16_t status_mask) {
+  if (!events_.reset(axes_.size(), capacity, status_mask)) {
+    printf("enable_events: EtherCAT is not initialized or capacity is 0\n");
+    return false;
+  }
+  return true;
+}
+
+const AxisEventStream& MotorApi::events() const { return events_; }
+
+uint64_t MotorApi::enabled_mask() const { return via_mailbox() ? published_masks().enabled : status_masks_.enabled; }
+
+uint64_t MotorApi::fault_mask() const { return via_mailbox() ? published_masks().fault : status_masks_.fault; }
+
+bool MotorApi::all_enabled() const {
+  if (!via_mailbox()) return status_masks_.all(status_masks_.enabled);
+  const StatusMasks masks = published_masks();
+  return masks.all(masks.enabled);
+}
+
+bool MotorApi::any_fault() const {
+  if (!via_mailbox()) return status_masks_.any(status_masks_.fault);
+  const StatusMasks masks = published_masks();
+  return masks.any(masks.fault);
+}
+
+/**
+ * @brief 解码全轴输入快照
+ * 
+ * 一次扫描所有轴的槽位表，按字段写入各自的连续数组；未映射的对象填0
+ */
+void MotorApi::decode_snapshot() {
+  const size_t n = axes_.size();
+  const AxisBlock* axes = axes_.data();
+  const uint8_t* pd = domain_pd_;
+  
+  for (size_t m = 0; m < n; ++m) {
+    const PdoSlots& s = axes[m].slots;
+    snapshot_.status_word[m] = s.status_word != kNoPdoSlot ? EC_READ_U16(pd + s.status_word) : 0;
+    snapshot_.actual_position[m] = s.actual_position != kNoPdoSlot ? EC_READ_S32(pd + s.actual_position) : 0;
+    snapshot_.actual_velocity[m] = s.actual_velocity != kNoPdoSlot ? EC_READ_S32(pd + s.actual_velocity) : 0;
+    snapshot_.actual_torque[m] = s.actual_torque != kNoPdoSlot ? EC_READ_S16(pd + s.actual_torque) : 0;
+    snapshot_.mode_display[m] = s.op_mode_display != kNoPdoSlot ? EC_READ_S8(pd + s.op_mode_display) : 0;
+    snapshot_.error_code[m] = s.error_code != kNoPdoSlot ? EC_READ_U16(pd + s.error_code) : 0;
+  }
+}
+
+/**
+ * @brief 采集全轴状态字
+ */
+void MotorApi::gather_status_words() {
+  const size_t n = axes_.size();
+  const AxisBlock* axes = axes_.data();
+  const uint8_t* pd = domain_pd_;
+  
+  for (size_t m = 0; m < n; ++m) {
+    unsigned int off = axes[m].slots.status_word;
+    snapshot_.status_word[m] = off != kNoPdoSlot ? EC_READ_U16(pd + off) : 0;
+  }
+  if (!events_.enabled()) return;
+  
+  // 事件检测还需要操作模式显示和错误代码
+  for (size_t m = 0; m < n; ++m) {
+    unsigned int off = axes[m].slots.op_mode_display;
+    snapshot_.mode_display[m] = off != kNoPdoSlot ? EC_READ_S8(pd + off) : 0;
+    off = axes[m].slots.error_code;
+    snapshot_.error_code[m] = off != kNoPdoSlot ? EC_READ_U16(pd + off) : 0;
+  }
 }
 
 /**
@@ -914,16 +959,652 @@ void MotorApi::receive_and_process() {
  * 将域数据排队并发送到主站
  */
 void MotorApi::queue_and_send() {
+  if (via_mailbox()) return;
+  if (!bus_held_ && !claim_bus()) return;
+  
+  const uint64_t start = CyclicRunner::now_ns();
+  if (rx_end_ns_) {
+    cycle_stats_.compute.record(start - rx_end_ns_);
+    rx_end_ns_ = 0;
+  }
+  
+  // 每周期锁存一次发出的目标位置，外推只使用相邻周期之差
+  AxisBlock* axes = axes_.data();
+  for (size_t m = 0; m < axes_.size(); ++m) axes[m].latch_target();
+  
+  ecrt_domain_queue(domain_);
+  ecrt_master_send(master_);
+  
+  const uint64_t end = CyclicRunner::now_ns();
+  cycle_stats_.send.record(end - start);
+  watchdog_.beat(end);
+  release_bus();
+  cycle_event_.signal();
+}
+
+/**
+ * @brief 占用总线收发区
+ */
+bool MotorApi::claim_bus() {
+  int expected = kBusFree;
+  bus_held_ = bus_owner_.compare_exchange_strong(expected, kBusCyclic, std::memory_order_acquire);
+  return bus_held_;
+}
+
+/**
+ * @brief 释放总线收发区（未持有时不做任何事）
+ */
+void MotorApi::release_bus() {
+  if (!bus_held_) return;
+  bus_held_ = false;
+  bus_owner_.store(kBusFree, std::memory_order_release);
+}
+
+const CycleStats& MotorApi::cycle_stats() const { return cycle_stats_; }
+
+void MotorApi::reset_cycle_stats() {
+  cycle_stats_.reset();
+  last_rx_start_ns_ = 0;
+  rx_end_ns_ = 0;
+}
+
+/**
+ * @brief 以实时周期运行控制循环
+ */
+bool MotorApi::run_cyclic(const RtConfig& config, const CycleCallback& callback) {
+  if (!domain_pd_) {
+    printf("run_cyclic: EtherCAT is not initialized\n");
+    return false;
+  }
+  if (via_mailbox()) {
+    printf("run_cyclic: the bus is owned by the threaded mode\n");
+    return false;
+  }
+  if (watchdog_tripped_.load(std::memory_order_acquire)) {
+    printf("run_cyclic: watchdog tripped, call rearm_watchdog() before restarting\n");
+    return false;
+  }
+  
+  CyclicRunner runner(config);
+  if (!runner.apply_realtime()) {
+    printf("run_cyclic: some real-time settings could not be applied, continuing\n");
+  }
+  
+  overruns_.store(0, std::memory_order_relaxed);
+  overrun_tripped_.store(false, std::memory_order_release);
+  const OverrunPolicy policy = runner.config().overrun_policy;
+  const uint32_t stop_after = runner.config().overrun_stop_after;
+  const bool pipelined = runner.config().pipelined;
+  if (pipelined) build_output_spans();
+  const bool threaded = threaded_.load(std::memory_order_acquire);
+  
+  runner.start();
+  watchdog_.arm(runner.cycle_start_ns());   // 只监督循环本身，循环之外的停顿不算停滞
+  // 线程模式的停止请求并入循环条件，降级周期跳过回调时同样能及时退出
+  while (run_.load() && !thread_stop_.load(std::memory_order_acquire)) {
+    runner.wait_next();
+    const uint64_t woke = CyclicRunner::now_ns();
+    cycle_stats_.wakeup.record(woke - runner.cycle_start_ns());
+    if (!run_.load() || thread_stop_.load(std::memory_order_acquire)) break;
+    const uint64_t cycle = runner.cycles();
+    if (!hooks_.run(HookPhase::PreReceive, *this, cycle)) break;
+    receive_and_process();
+    if (threaded) publish_feedback();
+    
+    if (watchdog_tripped_.load(std::memory_order_acquire)) {
+      printf("run_cyclic: watchdog tripped, quick stop\n");
+      if (bus_held_) {
+        quick_stop_all();
+        queue_and_send();
+      }
+      break;
+    }
+    
+    if (runner.overrun()) {
+      overruns_.fetch_add(1, std::memory_order_relaxed);
+      if (stop_after && runner.consecutive_overruns() >= stop_after) {
+        printf("run_cyclic: %u consecutive overruns, quick stop\n", runner.consecutive_overruns());
+        quick_stop_all();
+        queue_and_send();
+        overrun_tripped_.store(true, std::memory_order_release);
+        break;
+      }
+      // 降级周期跳过用户回调，让出时间追回相位，同时保证目标位置连续
+      // 降级输出同样经过发送前钩子，安全限位等模块对每一帧生效
+      if (pipelined && policy != OverrunPolicy::RunCallback) {
+        // 流水线模式先发出已算好的设定值，再由降级策略代替回调生成下一帧
+        restore_outputs();
+        queue_and_send();
+        apply_overrun_policy(policy);
+        consume_setpoints();
+        if (!hooks_.run(HookPhase::PreSend, *this, cycle)) break;
+        stage_outputs();
+        continue;
+      }
+      if (apply_overrun_policy(policy)) {
+        // 流式轴的下一个设定值本身就是连续的，照常取数，不让队列相对时间轴滞后
+        consume_setpoints();
+        if (!hooks_.run(HookPhase::PreSend, *this, cycle)) break;
+        queue_and_send();
+        continue;
+      }
+    }
+    
+    if (pipelined) {
+      // 先发出上一周期算好的设定值，再为下一帧计算
+      restore_outputs();
+      rx_end_ns_ = 0;   // 计算阶段改为围绕回调计时
+      send_at_offset(runner);
+      const uint64_t start = CyclicRunner::now_ns();
+      if (threaded) apply_commands();
+      poll_operations();
+      consume_setpoints();
+      const bool keep = hooks_.run(HookPhase::PostProcess, *this, cycle) && callback(*this) &&
+                        hooks_.run(HookPhase::PreSend, *this, cycle);
+      cycle_stats_.compute.record(CyclicRunner::now_ns() - start);
+      if (!keep) break;
+      stage_outputs();
+    } else {
+      if (threaded) apply_commands();
+      poll_operations();
+      consume_setpoints();
+      if (!hooks_.run(HookPhase::PostProcess, *this, cycle)) break;
+      if (!callback(*this)) break;
+      if (!hooks_.run(HookPhase::PreSend, *this, cycle)) break;
+      send_at_offset(runner);
+    }
+    
+    scheduler_.run(cycle);
+  }
+  // 接收之后因钩子或回调退出时不会发送，必须交还总线，否则看门狗再也无法接管
+  release_bus();
+  watchdog_.disarm();
+  
+  if (runner.missed() || runner.overruns()) {
+    printf("run_cyclic: %llu cycles, %llu overruns, %llu missed deadlines\n",
+           (unsigned long long)runner.cycles(), (unsigned long long)runner.overruns(),
+           (unsigned long long)runner.missed());
+  }
+  HistogramSummary wake = cycle_stats_.wakeup.summary();
+  HistogramSummary total = cycle_stats_.period.summary();
+  HistogramSummary jitter = cycle_stats_.send_jitter.summary();
+  printf("run_cyclic: wakeup p99 %llu ns max %llu ns, period p99 %llu ns max %llu ns, "
+         "send jitter p99 %llu ns max %llu ns\n",
+         (unsigned long long)wake.p99, (unsigned long long)wake.max,
+         (unsigned long long)total.p99, (unsigned long long)total.max,
+         (unsigned long long)jitter.p99, (unsigned long long)jitter.max);
+  if (hooks_.size(HookPhase::PreReceive) || hooks_.size(HookPhase::PostProcess) || hooks_.size(HookPhase::PreSend)) {
+    printf("run_cyclic: hook timing\n");
+    hooks_.print_timing();
+  }
+  return true;
+}
+
+/**
+ * @brief 在配置的发送偏移处提交并发送
+ * 
+ * 发送时刻固定在周期内的同一偏移，帧发出时间不随计算耗时变化
+ */
+void MotorApi::send_at_offset(CyclicRunner& runner) {
+  const uint64_t send_at = runner.send_time_ns();
+  if (runner.config().send_offset_ns) runner.wait_until(send_at);
+  const uint64_t sent = CyclicRunner::now_ns();
+  cycle_stats_.send_jitter.record(sent > send_at ? sent - send_at : 0);
+  queue_and_send();
+}
+
+/**
+ * @brief 从各轴设定值流取出本周期的目标位置
+ * 
+ * 未启用任何设定值流时只有一次判断
+ */
+void MotorApi::consume_setpoints() {
+  if (stream_count_ == 0) return;
+  const uint64_t now = CyclicRunner::now_ns();
+  for (size_t m = 0; m < streams_.size(); ++m) {
+    SetpointStream *stream = streams_[m].get();
+    int32_t target = 0;
+    if (stream && stream->next(now, target)) update_target_pos(m, target);
+  }
+}
+
+bool MotorApi::run_cyclic(uint32_t period_us, const CycleCallback& callback) {
+  return run_cyclic(RtConfig(period_us), callback);
+}
+
+/**
+ * @brief 在超时周期内按降级策略写入输出
+ */
+bool MotorApi::apply_overrun_policy(OverrunPolicy policy) {
+  const size_t n = axes_.size();
+  switch (policy) {
+    case OverrunPolicy::RunCallback:
+      return false;
+    case OverrunPolicy::ResendLast:
+      // 域数据仍保存上一周期的输出，逐轴重写一遍以覆盖回调可能的部分写入
+      for (size_t m = 0; m < n; ++m) {
+        const AxisBlock& axis = axes_[m];
+        if (axis.slots.control_word != kNoPdoSlot) EC_WRITE_U16(domain_pd_ + axis.slots.control_word, axis.last_control);
+        if (axis.target_valid && axis.slots.target_position != kNoPdoSlot) {
+          EC_WRITE_S32(domain_pd_ + axis.slots.target_position, axis.last_target);
+        }
+      }
+      return true;
+    case OverrunPolicy::HoldPosition:
+      for (size_t m = 0; m < n; ++m) update_target_pos(m, get_actual_pos(m));
+      return true;
+    case OverrunPolicy::Extrapolate:
+      for (size_t m = 0; m < n; ++m) {
+        const AxisBlock& axis = axes_[m];
+        if (axis.target_valid) update_target_pos(m, axis.last_target + axis.target_delta);
+      }
+      return true;
+  }
+  return false;
+}
+
+void MotorApi::build_output_spans() {
+  std::vector<std::pair<unsigned int, unsigned int>> fields;
+  for (size_t m = 0; m < axes_.size(); ++m) {
+    const PdoSlots& slots = axes_[m].slots;
+    const std::pair<unsigned int, unsigned int> outputs[] = {
+        {slots.control_word, 2},    {slots.target_position, 4}, {slots.target_velocity, 4},
+        {slots.target_torque, 2},   {slots.op_mode, 1},         {slots.resv1, 1}};
+    for (const auto& field : outputs) {
+      if (field.first != kNoPdoSlot) fields.push_back(std::make_pair(field.first, field.first + field.second));
+    }
+  }
+  std::sort(fields.begin(), fields.end());
+  
+  // 同一从站的RxPDO在域内通常连续，合并后每个从站只需一次拷贝
+  output_spans_.clear();
+  unsigned int image_size = 0;
+  for (const auto& field : fields) {
+    if (!output_spans_.empty() && field.first <= output_spans_.back().second) {
+      if (field.second > output_spans_.back().second) output_spans_.back().second = field.second;
+    } else {
+      output_spans_.push_back(field);
+    }
+    if (field.second > image_size) image_size = field.second;
+  }
+  
+  // 第一帧发出启动前域内已有的输出
+  staged_outputs_.assign(image_size, 0);
+  stage_outputs();
+}
+
+void MotorApi::stage_outputs() {
+  for (const auto& span : output_spans_) {
+    memcpy(&staged_outputs_[span.first], domain_pd_ + span.first, span.second - span.first);
+  }
+}
+
+void MotorApi::restore_outputs() {
+  for (const auto& span : output_spans_) {
+    memcpy(domain_pd_ + span.first, &staged_outputs_[span.first], span.second - span.first);
+  }
+}
+
+/**
+ * @brief 全部电机保持当前位置并发出快速停止命令（控制字0x0002）
+ */
+void MotorApi::quick_stop_all() {
+  const size_t n = axes_.size();
+  if (via_mailbox()) {
+    for (size_t m = 0; m < n; ++m) {
+      mailbox_.set_target(m, mailbox_.feedback(m).actual_position);
+      mailbox_.set_control(m, 0x0002);
+    }
+    return;
+  }
+  for (size_t m = 0; m < n; ++m) {
+    // 直接读域数据：看门狗调用时快照可能已过期
+    unsigned int off = axes_[m].slots.actual_position;
+    if (off != kNoPdoSlot) update_target_pos(m, EC_READ_S32(domain_pd_ + off));
+    write_control(m, 0x0002);
+  }
+}
+
+bool MotorApi::start_watchdog(const WatchdogConfig& config) {
+  if (!domain_pd_) {
+    printf("start_watchdog: EtherCAT is not initialized\n");
+    return false;
+  }
+  if (!watchdog_.start(config, [this](uint64_t stall_ns, bool first) { on_watchdog_stall(stall_ns, first); })) {
+    return false;
+  }
+  watchdog_tripped_.store(false);
+  return true;
+}
+
+void MotorApi::stop_watchdog() { watchdog_.stop(); }
+
+void MotorApi::arm_watchdog() { watchdog_.arm(CyclicRunner::now_ns()); }
+
+void MotorApi::disarm_watchdog() { watchdog_.disarm(); }
+
+bool MotorApi::rearm_watchdog() {
+  if (watchdog_.stalled()) {
+    printf("rearm_watchdog: the cyclic loop is still stalled\n");
+    return false;
+  }
+  watchdog_tripped_.store(false, std::memory_order_release);
+  return true;
+}
+
+const CycleWatchdog& MotorApi::watchdog() const { return watchdog_; }
+
+bool MotorApi::watchdog_tripped() const { return watchdog_tripped_.load(std::memory_order_acquire); }
+
+/**
+ * @brief 看门狗停滞处理
+ * 
+ * 周期线程停在总线收发区之外时，由看门狗线程完成一次收发并写入快速停止；
+ * 否则只置位触发标志，由周期线程恢复后处理
+ */
+void MotorApi::on_watchdog_stall(uint64_t stall_ns, bool first) {
+  watchdog_tripped_.store(true, std::memory_order_release);
+  if (first) {
+    printf("Watchdog: cyclic loop stalled for %.3f ms\n", stall_ns / 1e6);
+    // 停滞的周期线程可能正在写各轴状态、设定值流与钩子表，这里只打印原子统计
+    dump_cycle_timing();
+  }
+  
+  int expected = kBusFree;
+  if (!bus_owner_.compare_exchange_strong(expected, kBusWatchdog, std::memory_order_acquire)) {
+    if (first) printf("Watchdog: cyclic thread holds the bus, quick stop deferred until it resumes\n");
+    return;
+  }
+  BusThreadScope scope(this);
+  ecrt_master_receive(master_);
+  ecrt_domain_process(domain_);
+  quick_stop_all();
   ecrt_domain_queue(domain_);
   ecrt_master_send(master_);
+  bus_owner_.store(kBusFree, std::memory_order_release);
+}
+
+void MotorApi::dump_diagnostics() const {
+  dump_cycle_timing();
+  hooks_.print_timing();
+  for (size_t m = 0; m < streams_.size(); ++m) {
+    if (!streams_[m]) continue;
+    const SetpointStreamStats st = streams_[m]->stats();
+    printf("  stream %zu: fill %zu/%zu min %zu, consumed %llu, underruns %llu (%llu cycles), lead %lld ns\n", m,
+           st.fill, streams_[m]->capacity(), st.min_fill, (unsigned long long)st.consumed,
+           (unsigned long long)st.underruns, (unsigned long long)st.underrun_cycles, (long long)st.last_lead_ns);
+  }
+  if (events_.enabled()) {
+    printf("  events: %llu produced, capacity %zu\n", (unsigned long long)events_.produced(), events_.capacity());
+  }
+  printf("  masks: enabled=0x%llx fault=0x%llx\n", (unsigned long long)status_masks_.enabled,
+         (unsigned long long)status_masks_.fault);
+  for (size_t m = 0; m < axes_.size(); ++m) {
+    const AxisBlock& axis = axes_[m];
+    printf("  motor %zu: status 0x%04x control 0x%04x target %d\n", m,
+           m < snapshot_.size() ? snapshot_.status_word[m] : 0, axis.last_control, axis.last_target);
+  }
+}
+
+/**
+ * @brief 打印心跳与周期耗时直方图
+ * 
+ * 只读取原子计数，可在看门狗线程中与周期循环并发调用
+ */
+void MotorApi::dump_cycle_timing() const {
+  const char* names[] = {"wakeup", "receive", "compute", "send", "period", "send_jitter"};
+  const LatencyHistogram* hists[] = {&cycle_stats_.wakeup, &cycle_stats_.receive, &cycle_stats_.compute,
+                                     &cycle_stats_.send, &cycle_stats_.period, &cycle_stats_.send_jitter};
+  printf("=== Diagnostics: heartbeats %llu, max gap %.3f ms, stalls %llu ===\n",
+         (unsigned long long)watchdog_.beats(), watchdog_.max_gap_ns() / 1e6,
+         (unsigned long long)watchdog_.stall_count());
+  for (size_t i = 0; i < sizeof(hists) / sizeof(hists[0]); ++i) {
+    HistogramSummary h = hists[i]->summary();
+    printf("  %-11s n=%llu p50=%llu p99=%llu max=%llu ns\n", names[i], (unsigned long long)h.count,
+           (unsigned long long)h.p50, (unsigned long long)h.p99, (unsigned long long)h.max);
+  }
+}
+
+TaskScheduler& MotorApi::scheduler() { return scheduler_; }
+
+CycleHooks& MotorApi::hooks() { return hooks_; }
+
+bool MotorApi::enable_setpoint_stream(size_t motor, const SetpointStreamConfig& config) {
+  if (motor >= axes_.size()) {
+    printf("enable_setpoint_stream: invalid motor index %zu\n", motor);
+    return false;
+  }
+  if (streams_.size() < axes_.size()) streams_.resize(axes_.size());
+  if (!streams_[motor]) ++stream_count_;
+  streams_[motor].reset(new SetpointStream(config));
+  return true;
+}
+
+void MotorApi::disable_setpoint_stream(size_t motor) {
+  if (motor >= streams_.size() || !streams_[motor]) return;
+  streams_[motor].reset();
+  --stream_count_;
+}
+
+SetpointStream* MotorApi::setpoint_stream(size_t motor) {
+  return motor < streams_.size() ? streams_[motor].get() : nullptr;
+}
+
+bool MotorApi::open_cycle_timer(uint32_t period_us) {
+  return cycle_timer_.open(static_cast<uint64_t>(period_us) * 1000u);
+}
+
+int MotorApi::cycle_timer_fd() const { return cycle_timer_.fd(); }
+
+bool MotorApi::open_cycle_event() { return cycle_event_.open(); }
+
+int MotorApi::cycle_event_fd() const { return cycle_event_.fd(); }
+
+uint64_t MotorApi::drain_cycle_event() { return cycle_event_.drain(); }
+
+void MotorApi::close_event_fds() {
+  cycle_timer_.close();
+  cycle_event_.close();
 }
 
+/**
+ * @brief 定时器描述符可读时执行一个总线周期
+ * 
+ * 事件循环没能及时处理时直接跳过错过的周期（计入overrun_count()），不补发
+ */
+bool MotorApi::dispatch_timer(const CycleCallback& callback) {
+  if (!domain_pd_ || cycle_timer_.fd() < 0) {
+    printf("dispatch_timer: EtherCAT or cycle timer is not initialized\n");
+    return false;
+  }
+  if (via_mailbox()) {
+    printf("dispatch_timer: the bus is owned by the threaded mode\n");
+    return false;
+  }
+  
+  const uint64_t expired = cycle_timer_.read();
+  if (expired == 0) return true;
+  cycle_stats_.wakeup.record(CyclicRunner::now_ns() - cycle_timer_.deadline_ns());
+  if (expired > 1) overruns_.fetch_add(expired - 1, std::memory_order_relaxed);
+  
+  const uint64_t cycle = cycle_timer_.expirations();
+  if (!hooks_.run(HookPhase::PreReceive, *this, cycle)) return false;
+  receive_and_process();
+  
+  if (watchdog_tripped_.load(std::memory_order_acquire)) {
+    printf("dispatch_timer: watchdog tripped, quick stop\n");
+    if (bus_held_) {
+      quick_stop_all();
+      queue_and_send();
+    }
+    return false;
+  }
+  
+  poll_operations();
+  consume_setpoints();
+  if (!hooks_.run(HookPhase::PostProcess, *this, cycle) || !callback(*this) ||
+      !hooks_.run(HookPhase::PreSend, *this, cycle)) {
+    release_bus();
+    return false;
+  }
+  queue_and_send();
+  
+  scheduler_.run(cycle);
+  return true;
+}
+
+uint64_t MotorApi::snapshot_seq() const { return snapshot_seq_.load(std::memory_order_acquire); }
+
+bool MotorApi::poll_snapshot(uint64_t& seq) const {
+  const uint64_t now = snapshot_seq_.load(std::memory_order_acquire);
+  if (now == seq) return false;
+  seq = now;
+  return true;
+}
+
+bool MotorApi::start_workers(const WorkerPoolConfig& config) { return workers_.start(config); }
+
+void MotorApi::stop_workers() { workers_.stop(); }
+
+void MotorApi::parallel_for_axes(const AxisWorkerPool::RangeFn& fn) {
+  if (!threaded_.load(std::memory_order_relaxed)) {
+    workers_.run(axes_.size(), fn);
+    return;
+  }
+  // 线程模式下工作线程代总线线程直接访问域数据
+  const MotorApi *api = this;
+  workers_.run(axes_.size(), [api, &fn](size_t begin, size_t end) {
+    BusThreadScope scope(api);
+    fn(begin, end);
+  });
+}
+
+bool MotorApi::start_threaded(const RtConfig& config, const CycleCallback& callback) {
+  if (!domain_pd_) {
+    printf("start_threaded: EtherCAT is not initialized\n");
+    return false;
+  }
+  if (threaded_.load(std::memory_order_acquire)) {
+    printf("start_threaded: already running\n");
+    return false;
+  }
+  if (!mailbox_.reset(axes_.size())) {
+    printf("start_threaded: failed to allocate the axis mailbox\n");
+    return false;
+  }
+  publish_feedback();   // 内部线程第一次接收之前，读取函数返回当前输入
+  
+  thread_config_ = config;
+  thread_callback_ = callback;
+  thread_stop_.store(false, std::memory_order_relaxed);
+  threaded_.store(true, std::memory_order_release);
+  
+  SigintBlockScope sigint;
+  int rc = pthread_create(&bus_thread_, NULL, &MotorApi::threaded_entry, this);
+  if (rc != 0) {
+    printf("start_threaded: pthread_create failed: %s\n", strerror(rc));
+    threaded_.store(false, std::memory_order_release);
+    return false;
+  }
+  return true;
+}
+
+void MotorApi::stop_threaded() {
+  if (!threaded_.load(std::memory_order_acquire)) return;
+  thread_stop_.store(true, std::memory_order_release);
+  pthread_join(bus_thread_, NULL);
+  thread_stop_.store(false, std::memory_order_relaxed);
+  threaded_.store(false, std::memory_order_release);
+}
+
+bool MotorApi::threaded() const { return threaded_.load(std::memory_order_acquire); }
+
+void* MotorApi::threaded_entry(void* arg) {
+  MotorApi* api = static_cast<MotorApi*>(arg);
+  BusThreadScope scope(api);
+  api->run_cyclic(api->thread_config_, [api](MotorApi& self) {
+    return !api->thread_callback_ || api->thread_callback_(self);
+  });
+  return NULL;
+}
+
+AxisOp MotorApi::enable_all(uint32_t timeout_ms) {
+  // 在提交线程上分配，周期循环推进时不分配内存
+  std::vector<Cia402StateMachine> machines;
+  machines.reserve(motor_adapters_.size());
+  for (size_t m = 0; m < motor_adapters_.size(); ++m) {
+    machines.push_back(Cia402StateMachine(motor_adapters_[m]->stateTable()));
+  }
+  return ops_.enable(0, true, timeout_ms, std::move(machines));
+}
+
+AxisOp MotorApi::move_to(size_t motor, int32_t position, const MoveOptions& options) {
+  return ops_.move(motor, position, options);
+}
+
+AxisOp MotorApi::reset_faults(uint64_t mask, uint32_t timeout_ms) { return ops_.reset_faults(mask, timeout_ms); }
+
+void MotorApi::poll_operations() {
+  if (via_mailbox()) return;
+  ops_.poll(*this);
+}
+
+bool MotorApi::via_mailbox() const {
+  return threaded_.load(std::memory_order_relaxed) && t_bus_api != this;
+}
+
+/**
+ * @brief 将各轴输入发布到反馈区
+ * 
+ * 每周期只在此处复制一次，应用线程的读取不再触及域数据
+ */
+void MotorApi::publish_feedback() {
+  AxisFeedback* out = mailbox_.feedback_back();
+  const size_t n = mailbox_.size();
+  for (size_t m = 0; m < n; ++m) {
+    out[m].status_word = get_status(m);
+    out[m].actual_position = get_actual_pos(m);
+    out[m].actual_velocity = get_actual_velocity(m);
+    out[m].actual_torque = get_actual_torque(m);
+    out[m].mode_display = get_mode_display(m);
+    out[m].error_code = get_error_code(m);
+    out[m].drive_state = static_cast<uint8_t>(axes_[m].machine.state());
+  }
+  mailbox_.publish();
+}
+
+/**
+ * @brief 取走应用线程写入的命令
+ * 
+ * 只在命令变化的周期写出，正被写入的命令留到下一周期
+ */
+void MotorApi::apply_commands() {
+  const size_t n = mailbox_.size();
+  AxisCommand command;
+  for (size_t m = 0; m < n; ++m) {
+    if (!mailbox_.take(m, command)) continue;
+    if (command.fields & AxisCommand::kOpMode) set_opmode(m, command.op_mode, command.resv1);
+    if (command.fields & AxisCommand::kControl) write_control(m, command.control);
+    if (command.fields & AxisCommand::kTarget) update_target_pos(m, command.target_position);
+  }
+}
+
+uint64_t MotorApi::overrun_count() const { return overruns_.load(std::memory_order_relaxed); }
+
+bool MotorApi::overrun_tripped() const { return overrun_tripped_.load(std::memory_order_acquire); }
+
 /**
  * @brief 清理EtherCAT资源
  * 安全释放所有EtherCAT资源并重置状态
  */
 void MotorApi::cleanup() {
-  run_ = false;  // 设置运行标志为false
+  run_.store(false);  // 设置运行标志为false
+  MotorApi *self = this;
+  g_active_api.compare_exchange_strong(self, nullptr);
+  stop_threaded();    // 内部线程持有总线，先于其他资源停止
+  stop_watchdog();    // 看门狗可能访问主站，先于释放停止
+  stop_workers();
+  close_event_fds();
   
   // 释放主站资源
   if (master_) { 
@@ -942,9 +1623,122 @@ void MotorApi::cleanup() {
   slave_pos_.clear();
   motor_adapters_.clear();
   pdo_offsets_.clear();
+  axes_.reset(0);
+  snapshot_.resize(0);
+  groups_.clear();
+  status_masks_ = StatusMasks();
   regs_.clear();
+  last_rx_start_ns_ = 0;
+  rx_end_ns_ = 0;
+  bus_held_ = false;
+  bus_owner_.store(kBusFree);
+  watchdog_tripped_.store(false);
+}
+
+/**
+ * @brief 查找指定对象在域内的偏移量
+ * @param motor 电机索引
+ * @param index 对象索引
+ * @param subindex 子索引
+ * @param offset 输出偏移量
+ * @return true 找到，false 适配器未映射该对象
+ *
+ * 偏移量数组按先RxPDO后TxPDO的顺序排列，与注册时一致
+ */
+bool MotorApi::find_pdo_offset(size_t motor, uint16_t index, uint8_t subindex, unsigned int &offset,
+                               uint8_t *bit_length) const {
+  if (motor >= slave_count_ || index == 0x0000) return false;
+  
+  const auto& adapter = motor_adapters_[motor];
+  auto rx_pdo = adapter->getRxPdoConfig();
+  auto tx_pdo = adapter->getTxPdoConfig();
+  
+  for (size_t i = 0; i < rx_pdo.size(); ++i) {
+    if (rx_pdo[i].index == index && rx_pdo[i].subindex == subindex) {
+      offset = pdo_offsets_[motor][i];
+      if (bit_length) *bit_length = rx_pdo[i].bit_length;
+      return true;
+    }
+  }
+  for (size_t i = 0; i < tx_pdo.size(); ++i) {
+    if (tx_pdo[i].index == index && tx_pdo[i].subindex == subindex) {
+      offset = pdo_offsets_[motor][rx_pdo.size() + i];
+      if (bit_length) *bit_length = tx_pdo[i].bit_length;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 构建PDO槽位表
+ *
+ * 为每个电机解析常用CiA 402对象的域内偏移量，未映射的对象记为kNoPdoSlot
+ */
+void MotorApi::build_pdo_slots() {
+  struct SlotDef {
+    uint16_t index;
+    unsigned int PdoSlots::*slot;
+  };
+  static const SlotDef defs[] = {
+    {0x6040, &PdoSlots::control_word},
+    {0x607A, &PdoSlots::target_position},
+    {0x60FF, &PdoSlots::target_velocity},
+    {0x6071, &PdoSlots::target_torque},
+    {0x6060, &PdoSlots::op_mode},
+    {0x60C2, &PdoSlots::resv1},
+    {0x6041, &PdoSlots::status_word},
+    {0x6064, &PdoSlots::actual_position},
+    {0x606C, &PdoSlots::actual_velocity},
+    {0x6077, &PdoSlots::actual_torque},
+    {0x6061, &PdoSlots::op_mode_display},
+    {0x603F, &PdoSlots::error_code},
+  };
+  
+  axes_.reset(slave_count_);
+  snapshot_.resize(slave_count_);
+  for (size_t m = 0; m < slave_count_; ++m) {
+    for (const auto& def : defs) {
+      unsigned int offset = 0;
+      axes_[m].slots.*def.slot = find_pdo_offset(m, def.index, 0x00, offset) ? offset : kNoPdoSlot;
+    }
+  }
+}
+
+/**
+ * @brief 绑定各轴适配器与状态机
+ */
+void MotorApi::build_state_machines() {
+  for (size_t m = 0; m < axes_.size(); ++m) {
+    axes_[m].adapter = motor_adapters_[m].get();
+    axes_[m].machine.bind(motor_adapters_[m]->stateTable());
+  }
+}
+
+/**
+ * @brief 按适配器对电机分组
+ */
+void MotorApi::build_adapter_groups() {
+  groups_.clear();
+  for (size_t m = 0; m < slave_count_; ++m) {
+    MotorAdapter *adapter = motor_adapters_[m].get();
+    size_t g = 0;
+    while (g < groups_.size() && groups_[g].adapter != adapter) ++g;
+    if (g == groups_.size()) {
+      groups_.push_back(AdapterGroup());
+      groups_.back().adapter = adapter;
+    }
+    groups_[g].axes.push_back(m);
+    groups_[g].offsets.push_back(&pdo_offsets_[m]);
+  }
+  for (auto& group : groups_) {
+    group.status.assign(group.axes.size(), MotorAdapter::MotorStatus());
+    group.control.assign(group.axes.size(), MotorAdapter::MotorControl());
+  }
 }
 
+uint8_t *MotorApi::domain_data() const { return domain_pd_; }
+
 std::string MotorApi::get_adapter_name(size_t motor) const {
   if (motor >= slave_count_) return "Invalid motor";
   return motor_adapters_[motor]->getName();
@@ -964,20 +1758,23 @@ std::string MotorApi::get_motor_info(size_t motor) const {
  * @brief 信号处理函数
  * @param signum 信号编号
  * 
- * 处理SIGINT信号，触发清理操作
+ * 处理SIGINT信号，只清除运行标志：run_cyclic()随之返回（线程模式下内部线程随之退出），
+ * 资源由持有对象的线程调用cleanup()释放。处理函数中只做异步信号安全的操作
  */
 void MotorApi::signal_handler(int) {
-  if (g_active_api) {
-    printf("\nReceived interrupt signal, cleaning up...\n");
-    g_active_api->cleanup();
-  }
+  MotorApi *api = g_active_api.load();
+  if (!api) return;
+  static const char msg[] = "\nReceived interrupt signal, stopping...\n";
+  ssize_t rc = write(STDOUT_FILENO, msg, sizeof(msg) - 1);
+  (void)rc;
+  api->run_.store(false);
 }
 
 /**
  * @brief 检查运行状态
  * @return true 运行中，false 已停止
  */
-bool MotorApi::running() const { return run_; }
+bool MotorApi::running() const { return run_.load(); }
 
 /**
  * @brief 获取电机数量
@@ -994,19 +1791,18 @@ size_t MotorApi::motor_count() const { return slave_count_; }
  * 将操作模式和保留参数写入指定电机的PDO
  */
 void MotorApi::set_opmode(size_t motor, uint8_t op_mode, uint8_t resv1_value) {
-  if (motor >= slave_count_) return;
-  
-  auto adapter = motor_adapters_[motor];
-  auto rx_pdo = adapter->getRxPdoConfig();
+  if (motor >= axes_.size()) return;
+  if (via_mailbox()) {
+    mailbox_.set_opmode(motor, op_mode, resv1_value);
+    return;
+  }
   
-  // 查找操作模式PDO条目
-  for (size_t i = 0; i < rx_pdo.size(); ++i) {
-    if (rx_pdo[i].index == 0x6060) {  // 操作模式
-      memcpy(domain_pd_ + pdo_offsets_[motor][i], &op_mode, sizeof(uint8_t));
-    }
-    if (rx_pdo[i].index == 0x60C2) {  // 保留参数
-      memcpy(domain_pd_ + pdo_offsets_[motor][i], &resv1_value, sizeof(uint8_t));
-    }
+  const PdoSlots& slots = axes_[motor].slots;
+  if (slots.op_mode != kNoPdoSlot) {
+    EC_WRITE_U8(domain_pd_ + slots.op_mode, op_mode);
+  }
+  if (slots.resv1 != kNoPdoSlot) {
+    EC_WRITE_U8(domain_pd_ + slots.resv1, resv1_value);
   }
 }
 
@@ -1018,29 +1814,11 @@ void MotorApi::set_opmode(size_t motor, uint8_t op_mode, uint8_t resv1_value) {
  * 从指定电机的PDO中读取状态字
  */
 uint16_t MotorApi::get_status(size_t motor) const {
-  if (motor >= slave_count_) return 0;
-  
-  auto adapter = motor_adapters_[motor];
-  auto tx_pdo = adapter->getTxPdoConfig();
-  
-  // 查找状态字PDO条目
-  auto rx_pdo = adapter->getRxPdoConfig();
-  for (size_t i = 0; i < tx_pdo.size(); ++i) {
-    if (tx_pdo[i].index == 0x6041) {  // 状态字
-      unsigned int offset = pdo_offsets_[motor][rx_pdo.size() + i];
-      uint16_t status = *(uint16_t *)(domain_pd_ + offset);
-      
-      // 调试输出 - 只在Motor 0且状态变化时打印
-      static uint16_t last_status[2] = {0, 0};
-      if (motor == 0 && status != last_status[motor]) {
-        printf("Motor %zu: Status read from offset %u = 0x%04X\n", motor, offset, status);
-        last_status[motor] = status;
-      }
-      
-      return status;
-    }
-  }
-  return 0;
+  if (motor >= axes_.size()) return 0;
+  if (via_mailbox()) return mailbox_.feedback(motor).status_word;
+  if (snapshot_enabled_) return snapshot_.status_word[motor];
+  if (axes_[motor].slots.status_word == kNoPdoSlot) return 0;
+  return EC_READ_U16(domain_pd_ + axes_[motor].slots.status_word);
 }
 
 /**
@@ -1052,17 +1830,23 @@ uint16_t MotorApi::get_status(size_t motor) const {
  * @return 生成的控制字
  * 
  * 根据电机当前状态生成适当的控制字，管理状态机转换
- * 状态机转换逻辑：
- * - 0x00/0x40: 准备就绪，发送0x06进入准备状态
- * - 0x21: 准备状态，发送0x07使能操作，更新起始位置
- * - 0x23: 操作使能，发送0x0F进入运行状态
- * - 0x27: 运行状态，保持0x0F，设置运行使能标志
+ * 推进该轴的状态机：
+ * - 0x00/0x40: 发送0x06进入准备状态
+ * - 0x21: 发送0x07开启
+ * - 0x23: 发送0x0F启用操作
+ * - 0x27: 保持0x0F，置位运行使能标志
+ * - 故障: 发送0x80复位，厂家表可限制连续复位次数
  */
 uint16_t MotorApi::make_control(size_t motor, uint16_t status, int32_t &start_pos, bool &run_enable) {
-  if (motor >= slave_count_) return 0;
-  
-  auto adapter = motor_adapters_[motor];
-  return adapter->makeControl(status, start_pos, run_enable);
+  (void)start_pos;
+  if (motor >= axes_.size()) return 0;
+  return axes_[motor].machine.step(status, run_enable);
+}
+
+Cia402State MotorApi::get_drive_state(size_t motor) const {
+  if (motor >= axes_.size()) return Cia402State::Unknown;
+  if (via_mailbox()) return static_cast<Cia402State>(mailbox_.feedback(motor).drive_state);
+  return axes_[motor].machine.state();
 }
 
 /**
@@ -1073,18 +1857,15 @@ uint16_t MotorApi::make_control(size_t motor, uint16_t status, int32_t &start_po
  * 将控制字写入指定电机的PDO
  */
 void MotorApi::write_control(size_t motor, uint16_t control) {
-  if (motor >= slave_count_) return;
-  
-  auto adapter = motor_adapters_[motor];
-  auto rx_pdo = adapter->getRxPdoConfig();
-  
-  // 查找控制字PDO条目
-  for (size_t i = 0; i < rx_pdo.size(); ++i) {
-    if (rx_pdo[i].index == 0x6040) {  // 控制字
-      *(uint16_t *)(domain_pd_ + pdo_offsets_[motor][i]) = control;
-      break;
-    }
+  if (motor >= axes_.size()) return;
+  if (via_mailbox()) {
+    mailbox_.set_control(motor, control);
+    return;
   }
+  AxisBlock& axis = axes_[motor];
+  axis.last_control = control;
+  if (axis.slots.control_word == kNoPdoSlot) return;
+  EC_WRITE_U16(domain_pd_ + axis.slots.control_word, control);
 }
 
 /**
@@ -1095,36 +1876,177 @@ void MotorApi::write_control(size_t motor, uint16_t control) {
  * 将目标位置写入指定电机的PDO
  */
 void MotorApi::update_target_pos(size_t motor, int32_t pos) {
-  if (motor >= slave_count_) return;
-  
-  auto adapter = motor_adapters_[motor];
-  auto rx_pdo = adapter->getRxPdoConfig();
-  
-  // 查找目标位置PDO条目
-  for (size_t i = 0; i < rx_pdo.size(); ++i) {
-    if (rx_pdo[i].index == 0x607A) {  // 目标位置
-      *(int32_t *)(domain_pd_ + pdo_offsets_[motor][i]) = pos;
-      break;
-    }
+  if (motor >= axes_.size()) return;
+  if (via_mailbox()) {
+    mailbox_.set_target(motor, pos);
+    return;
   }
+  AxisBlock& axis = axes_[motor];
+  axis.record_target(pos);
+  if (axis.slots.target_position == kNoPdoSlot) return;
+  EC_WRITE_S32(domain_pd_ + axis.slots.target_position, pos);
 }
 
+/**
+ * @brief 获取实际位置
+ * @param motor 电机索引
+ * @return 实际位置值
+ * 
+ * 从指定电机的PDO中读取实际位置
+ */
 int32_t MotorApi::get_actual_pos(size_t motor) const {
-  if (motor >= slave_count_ || !domain_pd_) return 0;
-  
-  auto adapter = motor_adapters_[motor];
-  auto tx_pdo = adapter->getTxPdoConfig();
-  
-  // 查找实际位置PDO条目
-  auto rx_pdo = adapter->getRxPdoConfig();
-  for (size_t i = 0; i < tx_pdo.size(); ++i) {
-    if (tx_pdo[i].index == 0x6064) {  // 实际位置
-      return read_le_int32(domain_pd_ + pdo_offsets_[motor][rx_pdo.size() + i]);
+  if (motor >= axes_.size()) return 0;
+  if (via_mailbox()) return mailbox_.feedback(motor).actual_position;
+  if (snapshot_enabled_) return snapshot_.actual_position[motor];
+  if (axes_[motor].slots.actual_position == kNoPdoSlot) return 0;
+  return EC_READ_S32(domain_pd_ + axes_[motor].slots.actual_position);
+}
+
+int32_t MotorApi::get_actual_velocity(size_t motor) const {
+  if (motor >= axes_.size()) return 0;
+  if (via_mailbox()) return mailbox_.feedback(motor).actual_velocity;
+  if (snapshot_enabled_) return snapshot_.actual_velocity[motor];
+  if (axes_[motor].slots.actual_velocity == kNoPdoSlot) return 0;
+  return EC_READ_S32(domain_pd_ + axes_[motor].slots.actual_velocity);
+}
+
+int16_t MotorApi::get_actual_torque(size_t motor) const {
+  if (motor >= axes_.size()) return 0;
+  if (via_mailbox()) return mailbox_.feedback(motor).actual_torque;
+  if (snapshot_enabled_) return snapshot_.actual_torque[motor];
+  if (axes_[motor].slots.actual_torque == kNoPdoSlot) return 0;
+  return EC_READ_S16(domain_pd_ + axes_[motor].slots.actual_torque);
+}
+
+int8_t MotorApi::get_mode_display(size_t motor) const {
+  if (motor >= axes_.size()) return 0;
+  if (via_mailbox()) return mailbox_.feedback(motor).mode_display;
+  if (snapshot_enabled_) return snapshot_.mode_display[motor];
+  if (axes_[motor].slots.op_mode_display == kNoPdoSlot) return 0;
+  return EC_READ_S8(domain_pd_ + axes_[motor].slots.op_mode_display);
+}
+
+uint16_t MotorApi::get_error_code(size_t motor) const {
+  if (motor >= axes_.size()) return 0;
+  if (via_mailbox()) return mailbox_.feedback(motor).error_code;
+  if (snapshot_enabled_) return snapshot_.error_code[motor];
+  if (axes_[motor].slots.error_code == kNoPdoSlot) return 0;
+  return EC_READ_U16(domain_pd_ + axes_[motor].slots.error_code);
+}
+
+/**
+ * @brief 批量读取全部电机的状态字
+ * @param status 输出数组，长度不小于motor_count()
+ */
+void MotorApi::read_status_all(uint16_t *status) const {
+  const size_t n = axes_.size();
+  if (via_mailbox()) {
+    mailbox_.read([status](const AxisFeedback* all, size_t count) {
+      for (size_t m = 0; m < count; ++m) status[m] = all[m].status_word;
+    });
+    return;
+  }
+  if (snapshot_enabled_) {
+    if (n) memcpy(status, snapshot_.status_word.data(), n * sizeof(uint16_t));
+    return;
+  }
+  const AxisBlock* axes = axes_.data();
+  for (size_t m = 0; m < n; ++m) {
+    unsigned int off = axes[m].slots.status_word;
+    status[m] = off != kNoPdoSlot ? EC_READ_U16(domain_pd_ + off) : 0;
+  }
+}
+
+/**
+ * @brief 批量读取全部电机的实际位置
+ * @param positions 输出数组，长度不小于motor_count()
+ */
+void MotorApi::read_positions_all(int32_t *positions) const {
+  const size_t n = axes_.size();
+  if (via_mailbox()) {
+    mailbox_.read([positions](const AxisFeedback* all, size_t count) {
+      for (size_t m = 0; m < count; ++m) positions[m] = all[m].actual_position;
+    });
+    return;
+  }
+  if (snapshot_enabled_) {
+    if (n) memcpy(positions, snapshot_.actual_position.data(), n * sizeof(int32_t));
+    return;
+  }
+  const AxisBlock* axes = axes_.data();
+  for (size_t m = 0; m < n; ++m) {
+    unsigned int off = axes[m].slots.actual_position;
+    positions[m] = off != kNoPdoSlot ? EC_READ_S32(domain_pd_ + off) : 0;
+  }
+}
+
+/**
+ * @brief 批量写入全部电机的目标位置
+ * @param targets 目标位置数组，长度不小于motor_count()
+ */
+void MotorApi::write_targets_all(const int32_t *targets) {
+  const size_t n = axes_.size();
+  if (via_mailbox()) {
+    for (size_t m = 0; m < n; ++m) mailbox_.set_target(m, targets[m]);
+    return;
+  }
+  AxisBlock* axes = axes_.data();
+  for (size_t m = 0; m < n; ++m) {
+    unsigned int off = axes[m].slots.target_position;
+    axes[m].record_target(targets[m]);
+    if (off != kNoPdoSlot) EC_WRITE_S32(domain_pd_ + off, targets[m]);
+  }
+}
+
+/**
+ * @brief 批量写入全部电机的控制字
+ * @param controls 控制字数组，长度不小于motor_count()
+ */
+void MotorApi::write_controls_all(const uint16_t *controls) {
+  const size_t n = axes_.size();
+  if (via_mailbox()) {
+    for (size_t m = 0; m < n; ++m) mailbox_.set_control(m, controls[m]);
+    return;
+  }
+  AxisBlock* axes = axes_.data();
+  for (size_t m = 0; m < n; ++m) {
+    unsigned int off = axes[m].slots.control_word;
+    axes[m].last_control = controls[m];
+    if (off != kNoPdoSlot) EC_WRITE_U16(domain_pd_ + off, controls[m]);
+  }
+}
+
+void MotorApi::make_controls_all(const uint16_t *status, uint16_t *controls, bool *run_enable) {
+  const size_t n = axes_.size();
+  AxisBlock* axes = axes_.data();
+  for (size_t m = 0; m < n; ++m) {
+    controls[m] = axes[m].machine.step(status[m], run_enable[m]);
+  }
+}
+
+void MotorApi::read_motor_status_all(MotorAdapter::MotorStatus *out) {
+  for (auto& group : groups_) {
+    const size_t n = group.axes.size();
+    group.adapter->decodeBatch(domain_pd_, group.offsets.data(), n, group.status.data());
+    for (size_t i = 0; i < n; ++i) out[group.axes[i]] = group.status[i];
+  }
+}
+
+void MotorApi::write_motor_control_all(const MotorAdapter::MotorControl *in) {
+  for (auto& group : groups_) {
+    const size_t n = group.axes.size();
+    for (size_t i = 0; i < n; ++i) {
+      const size_t m = group.axes[i];
+      group.control[i] = in[m];
+      axes_[m].last_control = in[m].control_word;
+      axes_[m].record_target(in[m].target_position);
     }
+    group.adapter->encodeBatch(domain_pd_, group.offsets.data(), n, group.control.data());
   }
-  return 0;
 }
 
+size_t MotorApi::adapter_group_count() const { return groups_.size(); }
+
 /**
  * @brief 复位电机
  * @param motor 电机索引
@@ -1133,16 +2055,6 @@ int32_t MotorApi::get_actual_pos(size_t motor) const {
  * 控制字0x0080会触发电机驱动器的故障复位
  */
 void MotorApi::reset(size_t motor) {
-  if (motor >= slave_count_) return;
-  
-  auto adapter = motor_adapters_[motor];
-  auto rx_pdo = adapter->getRxPdoConfig();
-  
-  // 查找控制字PDO条目
-  for (size_t i = 0; i < rx_pdo.size(); ++i) {
-    if (rx_pdo[i].index == 0x6040) {  // 控制字
-      *(uint16_t *)(domain_pd_ + pdo_offsets_[motor][i]) = 0x0080;
-      break;
-    }
-  }
+  // 经write_control()记入last_control，ResendLast降级周期不会把复位控制字覆盖回去
+  write_control(motor, 0x0080);
 }
@@ -0,0 +1,90 @@
+#include "setpoint_stream.hpp"
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+  size_t p = 2;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+} // namespace
+
+SetpointStream::SetpointStream(const SetpointStreamConfig& config)
+    : mask_(round_up_pow2(config.capacity) - 1), config_(config), head_(0), cached_tail_(0), tail_(0),
+      cached_head_(0), primed_(false), last_(0), delta_(0), consumed_(0), underruns_(0),
+      underrun_cycles_(0), consecutive_(0), min_fill_(static_cast<size_t>(-1)), last_lead_ns_(0) {
+  ring_.resize(mask_ + 1);
+}
+
+bool SetpointStream::push(const Setpoint& setpoint) { return push(&setpoint, 1) == 1; }
+
+size_t SetpointStream::push(const Setpoint* setpoints, size_t count) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  size_t free_slots = capacity() - (head - cached_tail_);
+  if (free_slots < count) {
+    // 只有缓存的消费位置不够用时才读对方的缓存行
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    free_slots = capacity() - (head - cached_tail_);
+  }
+  const size_t n = count < free_slots ? count : free_slots;
+  for (size_t i = 0; i < n; ++i) ring_[(head + i) & mask_] = setpoints[i];
+  head_.store(head + n, std::memory_order_release);
+  return n;
+}
+
+bool SetpointStream::next(uint64_t now_ns, int32_t& target) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (cached_head_ == tail) cached_head_ = head_.load(std::memory_order_acquire);
+
+  if (cached_head_ != tail) {
+    const size_t fill = cached_head_ - tail;
+    if (fill < min_fill_.load(std::memory_order_relaxed)) min_fill_.store(fill, std::memory_order_relaxed);
+
+    const Setpoint& sp = ring_[tail & mask_];
+    delta_ = primed_ ? sp.position - last_ : 0;
+    last_ = sp.position;
+    if (sp.timestamp_ns) {
+      last_lead_ns_.store(static_cast<int64_t>(sp.timestamp_ns - now_ns), std::memory_order_relaxed);
+    }
+    tail_.store(tail + 1, std::memory_order_release);
+
+    primed_ = true;
+    consecutive_.store(0, std::memory_order_relaxed);
+    consumed_.fetch_add(1, std::memory_order_relaxed);
+    target = last_;
+    return true;
+  }
+
+  if (!primed_) return false;
+
+  // 欠载：按策略保持或外推，外推超过上限后保持
+  const uint32_t run = consecutive_.load(std::memory_order_relaxed);
+  if (run == 0) underruns_.fetch_add(1, std::memory_order_relaxed);
+  underrun_cycles_.fetch_add(1, std::memory_order_relaxed);
+  consecutive_.store(run + 1, std::memory_order_relaxed);
+  min_fill_.store(0, std::memory_order_relaxed);
+
+  if (config_.policy == UnderrunPolicy::Extrapolate && run < config_.max_extrapolate) {
+    last_ += delta_;
+  }
+  target = last_;
+  return true;
+}
+
+size_t SetpointStream::fill() const {
+  return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+}
+
+SetpointStreamStats SetpointStream::stats() const {
+  SetpointStreamStats s;
+  s.consumed = consumed_.load(std::memory_order_relaxed);
+  s.underruns = underruns_.load(std::memory_order_relaxed);
+  s.underrun_cycles = underrun_cycles_.load(std::memory_order_relaxed);
+  s.consecutive_underruns = consecutive_.load(std::memory_order_relaxed);
+  s.fill = fill();
+  const size_t min_fill = min_fill_.load(std::memory_order_relaxed);
+  s.min_fill = min_fill == static_cast<size_t>(-1) ? s.fill : min_fill;
+  s.last_lead_ns = last_lead_ns_.load(std::memory_order_relaxed);
+  return s;
+}
@@ -0,0 +1,102 @@
+#include "task_scheduler.hpp"
+#include "cyclic_runner.hpp"
+
+namespace {
+
+uint64_t gcd(uint64_t a, uint64_t b) {
+  while (b) {
+    uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+} // namespace
+
+size_t TaskScheduler::add(const std::string& name, uint32_t divisor, const Task& task, uint32_t phase) {
+  if (divisor == 0) divisor = 1;
+  phase = phase == kAutoPhase ? pick_phase(divisor) : phase % divisor;
+
+  Entry entry;
+  entry.info.name = name;
+  entry.info.divisor = divisor;
+  entry.info.phase = phase;
+  entry.info.runs = 0;
+  entry.info.last_ns = 0;
+  entry.info.max_ns = 0;
+  entry.fn = task;
+  tasks_.push_back(entry);
+  return tasks_.size() - 1;
+}
+
+void TaskScheduler::clear() { tasks_.clear(); }
+
+void TaskScheduler::run(uint64_t cycle) {
+  for (auto& entry : tasks_) {
+    TaskInfo& info = entry.info;
+    if (cycle % info.divisor != info.phase) continue;
+
+    const uint64_t start = CyclicRunner::now_ns();
+    entry.fn(cycle);
+    info.last_ns = CyclicRunner::now_ns() - start;
+    if (info.last_ns > info.max_ns) info.max_ns = info.last_ns;
+    ++info.runs;
+  }
+}
+
+/**
+ * @brief 选择与已注册任务重叠最少的相位
+ *
+ * 分频数为a、b，相位为p、q的两个任务在某个周期同时到期，
+ * 当且仅当p ≡ q (mod gcd(a, b))
+ */
+uint32_t TaskScheduler::pick_phase(uint32_t divisor) const {
+  uint32_t best = 0;
+  size_t best_overlap = static_cast<size_t>(-1);
+  for (uint32_t phase = 0; phase < divisor && best_overlap != 0; ++phase) {
+    size_t overlap = 0;
+    for (const auto& entry : tasks_) {
+      uint64_t g = gcd(divisor, entry.info.divisor);
+      if (phase % g == entry.info.phase % g) ++overlap;
+    }
+    if (overlap < best_overlap) {
+      best_overlap = overlap;
+      best = phase;
+    }
+  }
+  return best;
+}
+
+size_t TaskScheduler::worst_slot_load() const {
+  if (tasks_.empty()) return 0;
+
+  // 到期模式以所有分频数的最小公倍数为周期，超过上限时只检查上限内的周期
+  const uint64_t kMaxSpan = 1000000;
+  uint64_t span = 1;
+  for (const auto& entry : tasks_) {
+    span = span / gcd(span, entry.info.divisor) * entry.info.divisor;
+    if (span > kMaxSpan) {
+      span = kMaxSpan;
+      break;
+    }
+  }
+
+  size_t worst = 0;
+  for (uint64_t cycle = 0; cycle < span; ++cycle) {
+    size_t load = 0;
+    for (const auto& entry : tasks_) {
+      if (cycle % entry.info.divisor == entry.info.phase) ++load;
+    }
+    if (load > worst) worst = load;
+  }
+  return worst;
+}
+
+uint32_t TaskScheduler::divisor_for(uint64_t period_ns, uint64_t interval_ns) {
+  if (period_ns == 0) return 1;
+  uint64_t divisor = (interval_ns + period_ns / 2) / period_ns;
+  if (divisor == 0) divisor = 1;
+  if (divisor > 0xFFFFFFFFu) divisor = 0xFFFFFFFFu;
+  return static_cast<uint32_t>(divisor);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file stress_axis_events.cpp
+ * @brief 轴状态变化事件流压力测试
+ *
+ * 不依赖EtherCAT硬件，生产者每周期翻转一位状态字、恰好产生一个事件，两个消费者并发读取：
+ * 周期号严格递增，读取数与丢失数之和等于游标前进的事件数，结束时游标追上生产者。
+ *
+ * 失败时返回1。各线程定期让出CPU，单CPU上也能完成。
+ *
+ * 用法: ./stress_axis_events [迭代数=1000000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include "axis_events.hpp"
+
+namespace {
+
+/**
+ * @brief 事件流：两个消费者的顺序与丢失计数
+ */
+bool stress_axis_events(int n) {
+    const size_t axes = 4;
+    AxisEventStream events;
+    if (!events.reset(axes, 64, 0xFFFF)) return false;
+
+    uint16_t status[axes] = {0x40, 0x40, 0x40, 0x40};
+    int8_t mode[axes] = {8, 8, 8, 8};
+    uint16_t error[axes] = {0, 0, 0, 0};
+    events.detect(0, 0, status, mode, error);   // 基准
+
+    std::atomic<bool> stop(false);
+    struct Result {
+        AxisEventCursor cursor;
+        uint64_t start;
+        uint64_t got;
+        uint64_t bad;
+    };
+    Result results[2];
+    for (Result& r : results) {
+        r.cursor = events.cursor();
+        r.start = r.cursor.next;
+        r.got = 0;
+        r.bad = 0;
+    }
+
+    // 每周期翻转0轴状态字的一位，恰好产生一个事件
+    std::thread producer([&] {
+        for (int k = 1; k <= n; ++k) {
+            status[0] ^= 0x0001;
+            events.detect(static_cast<uint64_t>(k), static_cast<uint64_t>(k), status, mode, error);
+            if (!(k & 31)) std::this_thread::yield();
+        }
+        stop.store(true);
+    });
+
+    auto consume = [&](Result& r) {
+        AxisEvent batch[8];
+        uint64_t last_cycle = 0;
+        while (!stop.load() || r.cursor.next < events.produced()) {
+            const size_t count = events.read(r.cursor, batch, 8);
+            for (size_t i = 0; i < count; ++i) {
+                if (batch[i].cycle <= last_cycle || batch[i].axis != 0 || batch[i].changed() != 0x0001) ++r.bad;
+                last_cycle = batch[i].cycle;
+            }
+            r.got += count;
+            if (!count) std::this_thread::yield();
+        }
+    };
+    std::thread c1(consume, std::ref(results[0]));
+    std::thread c2(consume, std::ref(results[1]));
+    producer.join();
+    c1.join();
+    c2.join();
+
+    bool ok = events.produced() == static_cast<uint64_t>(n);
+    for (size_t i = 0; i < 2; ++i) {
+        const Result& r = results[i];
+        const bool balanced = r.got + r.cursor.lost == r.cursor.next - r.start && r.cursor.next == events.produced();
+        ok = ok && balanced && r.bad == 0;
+        printf("AxisEventStream: consumer %zu got %llu, lost %llu, %llu out of order, accounting %s\n", i,
+               (unsigned long long)r.got, (unsigned long long)r.cursor.lost, (unsigned long long)r.bad,
+               balanced ? "balanced" : "MISMATCH");
+    }
+    printf("AxisEventStream: %llu events  %s\n", (unsigned long long)events.produced(), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (n <= 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    return stress_axis_events(n) ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file stress_axis_mailbox.cpp
+ * @brief 线程模式轴数据交换区压力测试
+ *
+ * 不依赖EtherCAT硬件，模拟总线线程每周期发布反馈并取走命令，应用线程持续写命令、读取反馈：
+ * - 反馈读取不撕裂（同一次发布的各轴字段一致）且发布序号不回退
+ * - 命令槽取出的字段不撕裂（成对写入的操作模式与保留参数一致），目标位置不回退
+ *
+ * 失败时返回1。各线程定期让出CPU，单CPU上也能完成。
+ *
+ * 用法: ./stress_axis_mailbox [迭代数=1000000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "axis_mailbox.hpp"
+
+namespace {
+
+/**
+ * @brief 轴数据交换区：反馈双缓冲与命令槽
+ */
+bool stress_axis_mailbox(int n) {
+    const size_t axes = 8;
+    AxisMailbox mailbox;
+    if (!mailbox.reset(axes)) return false;
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> takes(0), torn_commands(0), backward_targets(0);
+
+    // 总线线程：每周期发布一次反馈，取走变化的命令
+    std::thread bus([&] {
+        std::vector<int32_t> last_target(axes, 0);
+        for (int k = 1; k <= n; ++k) {
+            AxisFeedback* fb = mailbox.feedback_back();
+            for (size_t m = 0; m < axes; ++m) {
+                fb[m].status_word = static_cast<uint16_t>(k);
+                fb[m].actual_position = k;
+                fb[m].actual_velocity = -k;
+                fb[m].error_code = static_cast<uint16_t>(k);
+            }
+            mailbox.publish();
+
+            AxisCommand command;
+            for (size_t m = 0; m < axes; ++m) {
+                if (!mailbox.take(m, command)) continue;
+                takes.fetch_add(1, std::memory_order_relaxed);
+                if ((command.fields & AxisCommand::kOpMode) && command.resv1 != static_cast<uint8_t>(~command.op_mode)) {
+                    torn_commands.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (command.fields & AxisCommand::kTarget) {
+                    if (command.target_position < last_target[m]) backward_targets.fetch_add(1, std::memory_order_relaxed);
+                    last_target[m] = command.target_position;
+                }
+            }
+            if (!(k & 63)) std::this_thread::yield();
+        }
+        stop.store(true);
+    });
+
+    // 应用线程：持续写命令，目标位置递增，操作模式与保留参数成对写入
+    std::thread writer([&] {
+        for (int32_t i = 1; !stop.load(); ++i) {
+            const size_t m = static_cast<size_t>(i) % axes;
+            mailbox.set_target(m, i);
+            mailbox.set_opmode(m, static_cast<uint8_t>(i), static_cast<uint8_t>(~i));
+            if (!(i & 15)) std::this_thread::yield();
+        }
+    });
+
+    // 读取线程：只有read()返回前的最后一次回调是一致的，结果在返回后判断
+    uint64_t reads = 0, torn_reads = 0, backward_reads = 0;
+    int32_t last_position = 0;
+    while (!stop.load()) {
+        bool consistent = true;
+        int32_t position = 0;
+        mailbox.read([&](const AxisFeedback* all, size_t count) {
+            consistent = true;
+            position = all[0].actual_position;
+            for (size_t m = 0; m < count; ++m) {
+                if (all[m].actual_position != position || all[m].actual_velocity != -position ||
+                    all[m].status_word != static_cast<uint16_t>(position)) {
+                    consistent = false;
+                }
+            }
+        });
+        ++reads;
+        if (!consistent) ++torn_reads;
+        if (position < last_position) ++backward_reads;
+        last_position = position;
+        std::this_thread::yield();
+    }
+    bus.join();
+    writer.join();
+
+    const bool ok = torn_reads == 0 && backward_reads == 0 && torn_commands.load() == 0 &&
+                    backward_targets.load() == 0 && mailbox.published() == static_cast<uint64_t>(n);
+    printf("AxisMailbox    : %llu publishes, %llu reads (%llu torn, %llu backwards), %llu takes (%llu torn, "
+           "%llu backwards)  %s\n",
+           (unsigned long long)mailbox.published(), (unsigned long long)reads, (unsigned long long)torn_reads,
+           (unsigned long long)backward_reads, (unsigned long long)takes.load(),
+           (unsigned long long)torn_commands.load(), (unsigned long long)backward_targets.load(), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (n <= 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    return stress_axis_mailbox(n) ? 0 : 1;
+}
@@ -75,16 +75,13 @@ int main() {
     
     printf("Starting control loop...\n");
      int i = 0;
-    // 主控制循环
-    while (api.running()) {
+    // 主控制循环：1ms绝对周期，接收/发送由run_cyclic完成
+    api.run_cyclic(1000, [&](MotorApi&) -> bool {
         // 设置所有电机的操作模式
         for (size_t m = 0; m < motor_count; ++m) {
             api.set_opmode(m, op, tmp);
         }
         
-        // 接收并处理EtherCAT数据
-        api.receive_and_process();
-        
         // 处理每个电机的状态和控制
         for (size_t m = 0; m < motor_count; ++m) {
             // 获取当前状态
@@ -99,7 +96,7 @@ int main() {
         }
         
         // 更新运行中电机的目标位置
-        bool any_motor_running = false;
+        const bool any_motor_running = api.status_masks().any(api.enabled_mask());
         
         for (size_t m = 0; m < motor_count; ++m) {
             if (run_enable[m]) {
@@ -111,7 +108,6 @@ int main() {
                 
                 start_pos[m] += step[m];
                 api.update_target_pos(m, start_pos[m]);
-                any_motor_running = true;
                 
                 if (i == 1000) {
                     printf("Motor %zu: Target=%d, Actual=%d, Status=0x%04X, RunEnable=%d\n", 
@@ -141,9 +137,8 @@ int main() {
                     printf("  Motor %zu: Status=0x%04X, RunEnable=%d, Actual=%d\n", 
                            m, status, run_enable[m], actual_pos[m]);
                     
-                    // 获取当前状态并重新生成控制字，让makeControl决定run_enable
-                    uint16_t control = api.make_control(m, status, start_pos[m], run_enable[m]);
-                    printf("  Generated control=0x%04X for motor %zu\n", control, m);
+                    // 状态机本周期已由上面的make_control()推进，这里只读取其状态，不再推进
+                    printf("  Drive state=%d for motor %zu\n", static_cast<int>(api.get_drive_state(m)), m);
                 }
                 i = 0;
             } else {
@@ -151,12 +146,8 @@ int main() {
             }
         }
         
-        // 发送EtherCAT数据
-        api.queue_and_send();
-        
-        // 1ms控制周期
-        usleep(1000);
-    }
+        return true;
+    });
     
     printf("Control loop terminated, cleaning up...\n");
     api.cleanup();
@@ -3,7 +3,6 @@
 #include <vector>
 #include <string>
 #include <chrono>
-#include <thread>
 #include <cmath>
 #include <signal.h>
 #include <iomanip>
@@ -196,10 +195,12 @@ int main(int argc, char* argv[]) {
     }
     
     int loop_count = 0;
+    std::vector<int32_t> targets(api.motor_count(), 0);
     auto start_time = std::chrono::steady_clock::now();
     
-    while (g_running && path_player.isPlaying()) {
-        auto loop_start = std::chrono::steady_clock::now();
+    // 8ms绝对周期：每周期先接收，再计算并写入，最后发送
+    api.run_cyclic(static_cast<uint32_t>(dt * 1e6 + 0.5), [&](MotorApi&) -> bool {
+        if (!g_running || !path_player.isPlaying()) return false;
         
         // 更新路径播放，获取目标位置
         double target_position_deg = path_player.updatePlayback();
@@ -207,10 +208,9 @@ int main(int argc, char* argv[]) {
         // 将角度转换为电机单位（考虑编码器分辨率和减速比）
         int32_t target_position = static_cast<int32_t>(target_position_deg * MOTOR_UNITS_PER_DEG);
         
-        // 设置所有电机的目标位置
-        for (int m = 0; m < api.motor_count(); m++) {
-            api.update_target_pos(m, target_position);
-        }
+        // 设置所有电机的目标位置（批量写入）
+        targets.assign(api.motor_count(), target_position);
+        api.write_targets_all(targets.data());
         
         // 发送控制命令
         for (int m = 0; m < api.motor_count(); m++) {
@@ -221,10 +221,6 @@ int main(int argc, char* argv[]) {
             api.write_control(m, control);
         }
         
-        // 处理EtherCAT通信
-        api.receive_and_process();
-        api.queue_and_send();
-        
         // 显示状态信息（每100个循环显示一次）
         if (loop_count % 100 == 0) {
             std::cout << "目标位置: " << std::fixed << std::setprecision(2) 
@@ -241,15 +237,8 @@ int main(int argc, char* argv[]) {
         }
         
         loop_count++;
-        
-        // 精确控制循环周期
-        auto loop_end = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration<double>(loop_end - loop_start).count();
-        
-        if (elapsed < dt) {
-            std::this_thread::sleep_for(std::chrono::duration<double>(dt - elapsed));
-        }
-    }
+        return true;
+    });
     
     // 停止所有电机
     std::cout << "停止所有电机..." << std::endl;